@@ -0,0 +1,131 @@
+// Per-turn latency of the decision pipeline over a corpus of recorded matches:
+// parse, model updates, decide and output timed separately, reported as p50/p99/max.
+// Turn 1 has its own budget and is reported apart from the later turns.
+// Record a corpus with REPLAY_FILE=<path> (tools/referee.cpp runs matches).
+// Build with the same -D flags as the bot to bench another strategy.
+// g++ -O2 -std=c++17 -o decision_bench bench/decision_bench.cpp && ./decision_bench [--repeat N] <replay>...
+
+#define NO_BOT_MAIN
+#include "../main.cpp"
+
+#include <chrono>
+#include <memory>
+
+class Samples
+{
+public:
+	const char *name;
+	vector<double> us;
+
+	Samples(const char *name) : name(name) {}
+
+	double percentile(double p) const
+	{
+		return us[min(us.size() - 1, (size_t)(p * us.size()))];
+	}
+
+	void report()
+	{
+		sort(us.begin(), us.end());
+		printf("%-8s p50 %9.2f us   p99 %9.2f us   max %9.2f us\n", name, percentile(0.5), percentile(0.99), us.back());
+	}
+};
+
+static double since(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+	int repeat = 10;
+	vector<const char *> paths;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--repeat" && i + 1 < argc)
+			repeat = atoi(argv[++i]);
+		else
+			paths.push_back(argv[i]);
+	}
+	if (paths.empty())
+	{
+		cerr << "usage: " << argv[0] << " [--repeat N] <replay>..." << endl;
+		return 2;
+	}
+
+	Samples parse("parse");
+	Samples models("models");
+	Samples decide("decide");
+	Samples output("output");
+	Samples total("total");
+	Samples firstTurn("turn 1");
+	int overBudget = 0;
+	for (const char *path : paths)
+	{
+		ReplayReader replay;
+		if (!replay.load(path))
+		{
+			cerr << "cannot read replay " << path << " (missing, or not replay format " << REPLAY_VERSION << ")" << endl;
+			return 1;
+		}
+		string input = replay.input();
+		for (int r = 0; r < repeat && !replay.frames.empty(); r++)
+		{
+			// Game holds search buffers: keep it off the stack
+			unique_ptr<Game> game(new Game(InputReader(input.data(), input.size())));
+			game->actionManager.fd = -1;
+			for (size_t t = 0; t < replay.frames.size(); t++)
+			{
+				bool first = game->turn == 0;
+				auto start = chrono::steady_clock::now();
+				if (first)
+					game->timer.start(FIRST_TURN_BUDGET_MS, FIRST_TURN_MARGIN_MS);
+				else
+					game->timer.start(TURN_BUDGET_MS, TURN_MARGIN_MS);
+				game->turnParse();
+				double parseUs = since(start);
+				auto modelsStart = chrono::steady_clock::now();
+				game->updateModels();
+				game->turn++;
+				double modelsUs = since(modelsStart);
+				auto decideStart = chrono::steady_clock::now();
+				game->decide();
+				double decideUs = since(decideStart);
+				auto outputStart = chrono::steady_clock::now();
+				for (auto &d : game->myDrones)
+					d.registerActions();
+				game->actionManager.execute();
+				double outputUs = since(outputStart);
+				double totalUs = since(start);
+				overBudget += totalUs > (first ? FIRST_TURN_BUDGET_MS : TURN_BUDGET_MS) * 1000.0;
+				if (first)
+				{
+					firstTurn.us.push_back(totalUs);
+					continue;
+				}
+				parse.us.push_back(parseUs);
+				models.us.push_back(modelsUs);
+				decide.us.push_back(decideUs);
+				output.us.push_back(outputUs);
+				total.us.push_back(totalUs);
+			}
+		}
+	}
+	if (total.us.empty())
+	{
+		cerr << "no turn after the first recorded" << endl;
+		return 1;
+	}
+
+	printf("%d turns from %d replays, %d runs each\n", (int)(total.us.size() + firstTurn.us.size()) / repeat, (int)paths.size(), repeat);
+	firstTurn.report();
+	printf("later turns:\n");
+	parse.report();
+	models.report();
+	decide.report();
+	output.report();
+	total.report();
+	printf("over budget (%d ms on turn 1, %d ms after): %d\n", FIRST_TURN_BUDGET_MS, TURN_BUDGET_MS, overBudget);
+	return overBudget == 0 ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+// Evasion heading search: former sampled protectionMode loop against EvasionKernel.
+// g++ -O2 -std=c++17 [-mavx2] -o evasion_bench bench/evasion_bench.cpp && ./evasion_bench [scenarios]
+
+#include "../engine/evasion.hpp"
+
+#include <chrono>
+
+struct Scenario
+{
+	int x;
+	int y;
+	int targetX;
+	int targetY;
+	CreatureStore store;
+};
+
+// Body of the former Game::protectionMode, returning the chosen move
+static bool legacyBestMove(Scenario &sc, int &bestX, int &bestY)
+{
+	CreatureStore &store = sc.store;
+	pair<double, double> originalVector = make_pair(sc.targetX - sc.x, sc.targetY - sc.y);
+	double norm = sqrt(originalVector.first * originalVector.first + originalVector.second * originalVector.second);
+	originalVector.first /= norm;
+	originalVector.second /= norm;
+
+	int minDistance = 1000000;
+	pair<int, int> bestPosition = make_pair(-1, -1);
+	for (int i = 0; i < 360; i++)
+	{
+		double angle = i * M_PI / 180;
+		pair<double, double> rotatedVector = make_pair(originalVector.first * cos(angle) - originalVector.second * sin(angle), originalVector.first * sin(angle) + originalVector.second * cos(angle));
+		pair<int, int> targetVector = make_pair(rotatedVector.first * 600, rotatedVector.second * 600);
+		bool danger = false;
+		for (double s = 0.02; s <= 1; s += 0.02)
+		{
+			pair<int, int> partialTarget = make_pair(sc.x + targetVector.first * s, sc.y + targetVector.second * s);
+			for (int m = 0; m < store.count; m++)
+			{
+				pair<int, int> partialMonster = make_pair(store.x[m] + store.vx[m] * s, store.y[m] + store.vy[m] * s);
+				int dist = sqrt((partialTarget.first - partialMonster.first) * (partialTarget.first - partialMonster.first) + (partialTarget.second - partialMonster.second) * (partialTarget.second - partialMonster.second));
+				if (dist < EMERGENCY_RADIUS + 100)
+				{
+					danger = true;
+					break;
+				}
+			}
+		}
+		if (danger)
+			continue;
+		int distance = sqrt((sc.x + targetVector.first - sc.targetX) * (sc.x + targetVector.first - sc.targetX) + (sc.y + targetVector.second - sc.targetY) * (sc.y + targetVector.second - sc.targetY));
+		if (distance < minDistance)
+		{
+			minDistance = distance;
+			bestPosition = make_pair(sc.x + targetVector.first, sc.y + targetVector.second);
+		}
+	}
+	bestX = bestPosition.first;
+	bestY = bestPosition.second;
+	return bestX != -1 && bestY != -1;
+}
+
+// Checks a chosen move independently of the closest approach formula both
+// searches rely on: drone and monsters are stepped along the turn in
+// CHECK_STEPS sub-steps and every sampled distance is compared to radius
+#define CHECK_STEPS 1000
+
+static bool collides(Scenario &sc, int toX, int toY, int radius)
+{
+	CreatureStore &store = sc.store;
+	for (int m = 0; m < store.count; m++)
+	{
+		for (int s = 0; s <= CHECK_STEPS; s++)
+		{
+			double t = (double)s / CHECK_STEPS;
+			double dx = sc.x + (toX - sc.x) * t - (store.x[m] + store.vx[m] * t);
+			double dy = sc.y + (toY - sc.y) * t - (store.y[m] + store.vy[m] * t);
+			if (dx * dx + dy * dy < (double)radius * radius)
+				return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, char **argv)
+{
+	int count = argc > 1 ? atoi(argv[1]) : 2000;
+	srand(7);
+	vector<Scenario> scenarios(count);
+	for (auto &sc : scenarios)
+	{
+		sc.x = 1000 + rand() % 8000;
+		sc.y = 1000 + rand() % 8000;
+		sc.targetX = rand() % 10000;
+		sc.targetY = rand() % 10000;
+		int monsters = 2 + rand() % 5;
+		for (int m = 0; m < monsters; m++)
+		{
+			int i = sc.store.add(m, -1, -1);
+			sc.store.x[i] = sc.x + rand() % 4000 - 2000;
+			sc.store.y[i] = sc.y + rand() % 4000 - 2000;
+			sc.store.vx[i] = rand() % 1081 - 540;
+			sc.store.vy[i] = rand() % 1081 - 540;
+		}
+	}
+
+	vector<pair<int, int>> legacy(count);
+	vector<pair<int, int>> kernel(count);
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+	{
+		if (!legacyBestMove(scenarios[i], legacy[i].first, legacy[i].second))
+			legacy[i] = make_pair(-1, -1);
+	}
+	double legacyTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / count;
+
+	EvasionKernel evasion;
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+	{
+		Scenario &sc = scenarios[i];
+		evasion.setMonsters(sc.store);
+		if (!evasion.bestMove(sc.x, sc.y, sc.targetX, sc.targetY, kernel[i].first, kernel[i].second))
+			kernel[i] = make_pair(-1, -1);
+	}
+	double kernelTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / count;
+
+	int mismatches = 0;
+	int legacyGrazes = 0;
+	int kernelGrazes = 0;
+	int legacyHits = 0;
+	int kernelHits = 0;
+	for (int i = 0; i < count; i++)
+	{
+		mismatches += legacy[i] != kernel[i];
+		if (legacy[i].first != -1)
+		{
+			legacyGrazes += collides(scenarios[i], legacy[i].first, legacy[i].second, EVASION_RADIUS);
+			legacyHits += collides(scenarios[i], legacy[i].first, legacy[i].second, EMERGENCY_RADIUS);
+		}
+		if (kernel[i].first != -1)
+		{
+			kernelGrazes += collides(scenarios[i], kernel[i].first, kernel[i].second, EVASION_RADIUS);
+			kernelHits += collides(scenarios[i], kernel[i].first, kernel[i].second, EMERGENCY_RADIUS);
+		}
+	}
+
+#ifdef __AVX2__
+	const char *path = "avx2";
+#else
+	const char *path = "scalar";
+#endif
+	cout << "scenarios      " << count << " (" << mismatches << " different moves)" << endl;
+	cout << "legacy         " << legacyTime << " us/drone, " << legacyGrazes << " moves graze a monster, " << legacyHits << " hit one" << endl;
+	cout << "kernel         " << kernelTime << " us/drone, " << kernelGrazes << " moves graze a monster, " << kernelHits << " hit one (" << path << ")" << endl;
+	return 0;
+}
@@ -0,0 +1,124 @@
+// Per-turn parse cost: legacy cin path against GameState::turnParse on InputReader.
+// g++ -O2 -std=c++17 -o parse_bench bench/parse_bench.cpp && ./parse_bench [turns]
+
+#include "../engine/game.hpp"
+
+#include <chrono>
+#include <fstream>
+
+#define BENCH_FILE "/tmp/fc23_parse_bench.txt"
+
+class ParseOnly : public GameState
+{
+public:
+	void decide() override {}
+};
+
+static void writeInput(int turns)
+{
+	ofstream out(BENCH_FILE);
+	srand(42);
+	out << 16 << "\n";
+	for (int i = 0; i < 16; i++)
+		out << 4 + i << " " << (i < 12 ? i % 4 : -1) << " " << (i < 12 ? i / 4 : -1) << "\n";
+	const char *radars[] = {"TL", "TR", "BL", "BR"};
+	for (int t = 0; t < turns; t++)
+	{
+		out << rand() % 100 << "\n" << rand() % 100 << "\n";
+		out << 3 << "\n" << 4 << "\n" << 5 << "\n" << 6 << "\n";
+		out << 2 << "\n" << 8 << "\n" << 9 << "\n";
+		out << 2 << "\n";
+		for (int d = 0; d < 2; d++)
+			out << d * 2 << " " << rand() % 10000 << " " << rand() % 10000 << " 0 " << rand() % 31 << "\n";
+		out << 2 << "\n";
+		for (int d = 0; d < 2; d++)
+			out << d * 2 + 1 << " " << rand() % 10000 << " " << rand() % 10000 << " 0 " << rand() % 31 << "\n";
+		out << 6 << "\n";
+		for (int s = 0; s < 6; s++)
+			out << s % 4 << " " << 10 + s << "\n";
+		out << 6 << "\n";
+		for (int c = 0; c < 6; c++)
+			out << 4 + c * 2 << " " << rand() % 10000 << " " << rand() % 10000 << " " << rand() % 800 - 400 << " " << rand() % 800 - 400 << "\n";
+		out << 32 << "\n";
+		for (int d = 0; d < 2; d++)
+			for (int c = 0; c < 16; c++)
+				out << d * 2 << " " << 4 + c << " " << radars[rand() % 4] << "\n";
+	}
+}
+
+// Token-for-token copy of the former cin based turnParse
+static long long legacyTurn()
+{
+	long long sum = 0;
+	int n, a, b, c, d, e;
+	cin >> a; cin.ignore(); sum += a;
+	cin >> a; cin.ignore(); sum += a;
+	for (int k = 0; k < 2; k++)
+	{
+		cin >> n; cin.ignore();
+		for (int i = 0; i < n; i++)
+		{
+			cin >> a; cin.ignore(); sum += a;
+		}
+	}
+	for (int k = 0; k < 2; k++)
+	{
+		cin >> n; cin.ignore();
+		for (int i = 0; i < n; i++)
+		{
+			cin >> a >> b >> c >> d >> e; cin.ignore(); sum += a + b + c + d + e;
+		}
+	}
+	cin >> n; cin.ignore();
+	for (int i = 0; i < n; i++)
+	{
+		cin >> a >> b; cin.ignore(); sum += a + b;
+	}
+	cin >> n; cin.ignore();
+	for (int i = 0; i < n; i++)
+	{
+		cin >> a >> b >> c >> d >> e; cin.ignore(); sum += a + b + c + d + e;
+	}
+	cin >> n; cin.ignore();
+	for (int i = 0; i < n; i++)
+	{
+		string radar;
+		cin >> a >> b >> radar; cin.ignore(); sum += a + b + radar.length();
+	}
+	return sum;
+}
+
+int main(int argc, char **argv)
+{
+	int turns = argc > 1 ? atoi(argv[1]) : 20000;
+	writeInput(turns);
+
+	freopen(BENCH_FILE, "r", stdin);
+	int creatureCount;
+	cin >> creatureCount; cin.ignore();
+	for (int i = 0; i < creatureCount; i++)
+	{
+		int id, color, type;
+		cin >> id >> color >> type; cin.ignore();
+	}
+	auto start = chrono::steady_clock::now();
+	long long checksum = 0;
+	for (int t = 0; t < turns; t++)
+		checksum += legacyTurn();
+	double legacy = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / turns;
+
+	freopen(BENCH_FILE, "r", stdin);
+	ParseOnly game;
+	start = chrono::steady_clock::now();
+	for (int t = 0; t < turns; t++)
+	{
+		game.turnParse();
+		game.turn++;
+	}
+	double reader = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / turns;
+
+	cout << "turns            " << turns << " (checksum " << checksum << ")" << endl;
+	cout << "cin turnParse    " << legacy << " ns/turn (tokens only)" << endl;
+	cout << "turnParse        " << reader << " ns/turn (tokens + state update)" << endl;
+	return 0;
+}
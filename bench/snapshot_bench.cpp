@@ -0,0 +1,121 @@
+// GameSnapshot round trip over recorded matches: every turn's snapshot is
+// restored into a second game parsed to the end of the match, which must
+// then match it again (byte for byte, and through the monster filter and
+// drone queries).
+// Also times snapshot() and restore(). Exits non-zero on any mismatch.
+// g++ -O2 -std=c++17 -o snapshot_bench bench/snapshot_bench.cpp && ./snapshot_bench <replay>...
+
+#include "../engine/game.hpp"
+
+#include <chrono>
+#include <memory>
+
+class ParseOnly : public GameState
+{
+public:
+	ParseOnly(const InputReader &source) : GameState(source) {}
+	void decide() override {}
+
+	void parseTurn()
+	{
+		turnParse();
+		updateModels();
+		turn++;
+	}
+};
+
+// What the bot reads from the state, beyond the snapshot bytes
+static vector<double> observe(const GameState &game)
+{
+	vector<double> seen;
+	for (auto *drones : {&game.myDrones, &game.oppDrones})
+	{
+		for (auto &d : *drones)
+		{
+			seen.push_back(d.x);
+			seen.push_back(d.y);
+			seen.push_back(d.lit);
+			seen.push_back(d.scanCount);
+			seen.push_back(game.monsterFilter.danger(d.x, d.y, DANGER_RADIUS));
+		}
+	}
+	seen.push_back(game.visibleCreatureCount);
+	seen.push_back(game.myScanCount);
+	seen.push_back(game.mySavedScanCount);
+	seen.push_back(game.oppSavedScanCount);
+	return seen;
+}
+
+static double since(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		cerr << "usage: " << argv[0] << " <replay>..." << endl;
+		return 2;
+	}
+	int failures = 0;
+	double snapshotNs = 0;
+	double restoreNs = 0;
+	int timed = 0;
+	for (int a = 1; a < argc; a++)
+	{
+		ReplayReader replay;
+		if (!replay.load(argv[a]))
+		{
+			cerr << "cannot read replay " << argv[a] << " (missing, or not replay format " << REPLAY_VERSION << ")" << endl;
+			return 1;
+		}
+		if (replay.frames.size() < 2)
+			continue;
+		string input = replay.input();
+		// Games hold the monster filter: keep them off the stack
+		unique_ptr<ParseOnly> game(new ParseOnly(InputReader(input.data(), input.size())));
+		unique_ptr<ParseOnly> other(new ParseOnly(InputReader(input.data(), input.size())));
+		game->actionManager.fd = -1;
+		other->actionManager.fd = -1;
+		for (size_t t = 0; t < replay.frames.size(); t++)
+			other->parseTurn();
+		unique_ptr<GameSnapshot> before(new GameSnapshot());
+		unique_ptr<GameSnapshot> after(new GameSnapshot());
+		for (size_t t = 0; t < replay.frames.size(); t++)
+		{
+			game->parseTurn();
+			*before = game->snapshot();
+			other->restore(*before);
+			*after = other->snapshot();
+			bool same = memcmp(before.get(), after.get(), sizeof(GameSnapshot)) == 0;
+			bool sameView = observe(*other) == observe(*game);
+			if (!same || !sameView)
+			{
+				failures++;
+				cerr << argv[a] << ": restore of turn " << before->turn << " differs" << (same ? " in the views" : " in the snapshot") << endl;
+			}
+		}
+
+		const int rounds = 1000;
+		auto start = chrono::steady_clock::now();
+		for (int r = 0; r < rounds; r++)
+			*after = game->snapshot();
+		snapshotNs += since(start);
+		start = chrono::steady_clock::now();
+		for (int r = 0; r < rounds; r++)
+			game->restore(*before);
+		restoreNs += since(start);
+		timed += rounds;
+	}
+	if (timed == 0)
+	{
+		cerr << "no replay long enough" << endl;
+		return 1;
+	}
+
+	printf("snapshot %zu bytes\n", sizeof(GameSnapshot));
+	printf("snapshot %9.1f ns   restore %9.1f ns\n", snapshotNs / timed, restoreNs / timed);
+	printf("round trips differing: %d\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#ifndef ENGINE_BEAM_HPP
+#define ENGINE_BEAM_HPP
+
+#include "plan.hpp"
+#include "timing.hpp"
+
+// Beam search over joint moves of my two drones (PlanMoves); the opponent's
+// drones follow fixed actions. Only (parent, moves, score) is kept per
+// candidate, the survivors are simulated again. Anytime: at the deadline the
+// best candidate found so far gives the first actions.
+class BeamPlanner
+{
+	class Candidate
+	{
+	public:
+		int parent;
+		int moves;
+		double score;
+
+		bool operator<(const Candidate &c) const { return score > c.score; }
+	};
+
+	SimState beam[BEAM_WIDTH];
+	SimState next[BEAM_WIDTH];
+	int firstMoves[BEAM_WIDTH];
+	int nextFirstMoves[BEAM_WIDTH];
+	Candidate candidates[BEAM_WIDTH * PLAN_MOVES * PLAN_MOVES];
+
+public:
+	int depthReached;
+	int simulations;
+
+	// Returns false only when not even one candidate was evaluated in time
+	bool plan(const SimState &root, const SimAction *oppActions, const TurnTimer &timer, SimAction *best)
+	{
+		SimAction actions[SIM_DRONES];
+		actions[2] = oppActions[0];
+		actions[3] = oppActions[1];
+		beam[0] = root;
+		firstMoves[0] = 0;
+		int width = 1;
+		int bestMoves = -1;
+		depthReached = 0;
+		simulations = 0;
+		for (int depth = 0; depth < BEAM_DEPTH; depth++)
+		{
+			int count = 0;
+			bool expired = false;
+			for (int b = 0; b < width && !expired; b++)
+			{
+				for (int moves = 0; moves < PLAN_MOVES * PLAN_MOVES; moves++)
+				{
+					int m0 = moves % PLAN_MOVES;
+					int m1 = moves / PLAN_MOVES;
+					if (!PlanMoves::useful(beam[b].drones[0], m0) || !PlanMoves::useful(beam[b].drones[1], m1))
+						continue;
+					if ((simulations & 31) == 0 && timer.searchExpired())
+					{
+						expired = true;
+						break;
+					}
+					SimState s = beam[b];
+					actions[0] = PlanMoves::droneAction(s.drones[0], m0);
+					actions[1] = PlanMoves::droneAction(s.drones[1], m1);
+					s.step(actions);
+					simulations++;
+					candidates[count].parent = b;
+					candidates[count].moves = moves;
+					candidates[count].score = PlanEvaluator::evaluate(s);
+					count++;
+				}
+			}
+			if (count == 0)
+				break;
+			int kept = min(count, BEAM_WIDTH);
+			partial_sort(candidates, candidates + kept, candidates + count);
+			bestMoves = depth == 0 ? candidates[0].moves : firstMoves[candidates[0].parent];
+			if (expired)
+				break;
+			for (int j = 0; j < kept; j++)
+			{
+				const Candidate &c = candidates[j];
+				next[j] = beam[c.parent];
+				actions[0] = PlanMoves::droneAction(next[j].drones[0], c.moves % PLAN_MOVES);
+				actions[1] = PlanMoves::droneAction(next[j].drones[1], c.moves / PLAN_MOVES);
+				next[j].step(actions);
+				nextFirstMoves[j] = depth == 0 ? c.moves : firstMoves[c.parent];
+			}
+			for (int j = 0; j < kept; j++)
+			{
+				beam[j] = next[j];
+				firstMoves[j] = nextFirstMoves[j];
+			}
+			width = kept;
+			depthReached = depth + 1;
+		}
+		if (bestMoves < 0)
+			return false;
+		best[0] = PlanMoves::droneAction(root.drones[0], bestMoves % PLAN_MOVES);
+		best[1] = PlanMoves::droneAction(root.drones[1], bestMoves / PLAN_MOVES);
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef ENGINE_BELIEF_HPP
+#define ENGINE_BELIEF_HPP
+
+#include "geometry.hpp"
+#include "sim.hpp"
+
+// Box each creature must be in, by store index. Every turn a box grows by the
+// creature's top speed and is clipped to its habitat, then cut by the radar
+// quadrant each of my drones reports. Visible creatures collapse to a point,
+// which moves by their known speed on the next turn.
+class BeliefTracker
+{
+public:
+	int minX[MAX_ENTITIES];
+	int maxX[MAX_ENTITIES];
+	int minY[MAX_ENTITIES];
+	int maxY[MAX_ENTITIES];
+	// Seen this turn: the box is exact
+	uint64_t exact;
+
+	void reset(const CreatureStore &store)
+	{
+		exact = 0;
+		for (int i = 0; i < store.count; i++)
+			habitat(store, i);
+	}
+
+	void habitat(const CreatureStore &store, int i)
+	{
+		minX[i] = 0;
+		maxX[i] = MAP_SIZE - 1;
+		minY[i] = SimState::habitatTop(store.type[i]);
+		maxY[i] = SimState::habitatBottom(store.type[i]);
+	}
+
+	void predict(const CreatureStore &store)
+	{
+		for (uint64_t m = store.all() & ~store.flags[FLAG_DEAD]; m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			if (store.flags[FLAG_VISIBLE] & BIT(i))
+			{
+				minX[i] = maxX[i] = store.x[i];
+				minY[i] = maxY[i] = store.y[i];
+				continue;
+			}
+			int shiftX = 0;
+			int shiftY = 0;
+			int grow = store.type[i] < 0 ? MONSTER_ATTACK_SPEED : FISH_FLEE_SPEED;
+			if (exact & BIT(i))
+			{
+				shiftX = store.vx[i];
+				shiftY = store.vy[i];
+				grow = 0;
+			}
+			minX[i] = max(minX[i] + shiftX - grow, 0);
+			maxX[i] = min(maxX[i] + shiftX + grow, MAP_SIZE - 1);
+			minY[i] = max(minY[i] + shiftY - grow, SimState::habitatTop(store.type[i]));
+			maxY[i] = min(maxY[i] + shiftY + grow, SimState::habitatBottom(store.type[i]));
+		}
+		exact = store.flags[FLAG_VISIBLE];
+	}
+
+	// Blips say whether the creature is above (T) and left (L) of the drone
+	void cut(const CreatureStore &store, int droneX, int droneY, const RadarDirection *blips)
+	{
+		for (uint64_t m = store.all() & ~store.flags[FLAG_DEAD] & ~exact; m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			RadarDirection dir = blips[store.id[i]];
+			int loX = dir == TOP_LEFT || dir == BOTTOM_LEFT ? 0 : droneX;
+			int hiX = dir == TOP_LEFT || dir == BOTTOM_LEFT ? droneX - 1 : MAP_SIZE - 1;
+			int loY = dir == TOP_LEFT || dir == TOP_RIGHT ? 0 : droneY;
+			int hiY = dir == TOP_LEFT || dir == TOP_RIGHT ? droneY - 1 : MAP_SIZE - 1;
+			// An empty box means the motion model was wrong: keep what the radar says
+			if (max(minX[i], loX) > min(maxX[i], hiX) || max(minY[i], loY) > min(maxY[i], hiY))
+				habitat(store, i);
+			minX[i] = max(minX[i], loX);
+			maxX[i] = max(min(maxX[i], hiX), minX[i]);
+			minY[i] = max(minY[i], loY);
+			maxY[i] = max(min(maxY[i], hiY), minY[i]);
+		}
+	}
+
+	int estimateX(int i) const
+	{
+		return (minX[i] + maxX[i]) / 2;
+	}
+
+	int estimateY(int i) const
+	{
+		return (minY[i] + maxY[i]) / 2;
+	}
+};
+
+// Particle filter over monster positions. A visible monster collapses all its
+// particles on its position; out of sight they move with their own speed,
+// particles outside a radar quadrant or inside a drone's detection range are
+// dropped, and the holes are refilled from survivors with a perturbed heading
+// and speed. With no survivor left, particles are drawn in the belief box.
+class MonsterFilter
+{
+	float px[FILTER_MONSTERS][FILTER_PARTICLES];
+	float py[FILTER_MONSTERS][FILTER_PARTICLES];
+	float pvx[FILTER_MONSTERS][FILTER_PARTICLES];
+	float pvy[FILTER_MONSTERS][FILTER_PARTICLES];
+	int alive[FILTER_MONSTERS];
+	int storeIndex[FILTER_MONSTERS];
+	int count;
+	uint32_t rng;
+
+	uint32_t random()
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		return rng;
+	}
+
+	void draw(int m, int p, const BeliefTracker &beliefs)
+	{
+		int i = storeIndex[m];
+		int heading = random() % HEADING_RESOLUTION;
+		px[m][p] = beliefs.minX[i] + random() % (beliefs.maxX[i] - beliefs.minX[i] + 1);
+		py[m][p] = beliefs.minY[i] + random() % (beliefs.maxY[i] - beliefs.minY[i] + 1);
+		pvx[m][p] = HEADINGS.x[heading] * MONSTER_SPEED;
+		pvy[m][p] = HEADINGS.y[heading] * MONSTER_SPEED;
+	}
+
+	// Turn by up to 30 degrees; one in four chases at attack speed
+	void perturb(int m, int p)
+	{
+		int turn = (int)(random() % (HEADING_RESOLUTION / 6 + 1)) - HEADING_RESOLUTION / 12;
+		int heading = (turn + HEADING_RESOLUTION) % HEADING_RESOLUTION;
+		float vx = pvx[m][p];
+		float vy = pvy[m][p];
+		float norm = sqrtf(vx * vx + vy * vy);
+		float speed = random() % 4 == 0 ? MONSTER_ATTACK_SPEED : MONSTER_SPEED;
+		float scale = norm > 0 ? speed / norm : 0;
+		pvx[m][p] = (vx * HEADINGS.x[heading] - vy * HEADINGS.y[heading]) * scale;
+		pvy[m][p] = (vx * HEADINGS.y[heading] + vy * HEADINGS.x[heading]) * scale;
+	}
+
+public:
+	MonsterFilter() : count(0), rng(0x9e3779b9) {}
+
+	void reset(const CreatureStore &store, const BeliefTracker &beliefs)
+	{
+		count = 0;
+		for (uint64_t m = store.monsters(); m && count < FILTER_MONSTERS; m &= m - 1)
+		{
+			storeIndex[count] = __builtin_ctzll(m);
+			alive[count] = FILTER_PARTICLES;
+			for (int p = 0; p < FILTER_PARTICLES; p++)
+				draw(count, p, beliefs);
+			count++;
+		}
+	}
+
+	void predict(const CreatureStore &store)
+	{
+		const float top = TOP_LIMIT;
+		const float bottom = MAP_SIZE - 1;
+		for (int m = 0; m < count; m++)
+		{
+			int i = storeIndex[m];
+			if (store.flags[FLAG_VISIBLE] & BIT(i))
+			{
+				for (int p = 0; p < FILTER_PARTICLES; p++)
+				{
+					px[m][p] = store.x[i];
+					py[m][p] = store.y[i];
+					pvx[m][p] = store.vx[i];
+					pvy[m][p] = store.vy[i];
+				}
+				continue;
+			}
+			float *x = px[m];
+			float *y = py[m];
+			float *vx = pvx[m];
+			float *vy = pvy[m];
+			for (int p = 0; p < FILTER_PARTICLES; p++)
+			{
+				float ny = y[p] + vy[p];
+				vy[p] = ny < top || ny > bottom ? -vy[p] : vy[p];
+				x[p] = min(max(x[p] + vx[p], 0.0f), (float)(MAP_SIZE - 1));
+				y[p] = min(max(y[p] + vy[p], top), bottom);
+			}
+		}
+	}
+
+	// Drops particles that contradict what one of my drones reports: the
+	// quadrant of the radar blip, and no sighting within its detection range
+	void observe(const CreatureStore &store, int droneX, int droneY, int range, const RadarDirection *blips)
+	{
+		for (int m = 0; m < count; m++)
+		{
+			int i = storeIndex[m];
+			if (store.flags[FLAG_VISIBLE] & BIT(i))
+				continue;
+			RadarDirection dir = blips[store.id[i]];
+			bool left = dir == TOP_LEFT || dir == BOTTOM_LEFT;
+			bool top = dir == TOP_LEFT || dir == TOP_RIGHT;
+			int kept = 0;
+			for (int p = 0; p < alive[m]; p++)
+			{
+				float dx = px[m][p] - droneX;
+				float dy = py[m][p] - droneY;
+				if ((dx < 0) != left || (dy < 0) != top || dx * dx + dy * dy <= (float)range * range)
+					continue;
+				px[m][kept] = px[m][p];
+				py[m][kept] = py[m][p];
+				pvx[m][kept] = pvx[m][p];
+				pvy[m][kept] = pvy[m][p];
+				kept++;
+			}
+			alive[m] = kept;
+		}
+	}
+
+	void resample(const CreatureStore &store, const BeliefTracker &beliefs)
+	{
+		for (int m = 0; m < count; m++)
+		{
+			if (store.flags[FLAG_VISIBLE] & BIT(storeIndex[m]))
+			{
+				alive[m] = FILTER_PARTICLES;
+				continue;
+			}
+			int survivors = alive[m];
+			for (int p = 0; p < survivors; p++)
+			{
+				if (random() % 8 == 0)
+					perturb(m, p);
+			}
+			for (int p = survivors; p < FILTER_PARTICLES; p++)
+			{
+				if (survivors == 0)
+				{
+					draw(m, p, beliefs);
+					continue;
+				}
+				int from = random() % survivors;
+				px[m][p] = px[m][from];
+				py[m][p] = py[m][from];
+				pvx[m][p] = pvx[m][from];
+				pvy[m][p] = pvy[m][from];
+				perturb(m, p);
+			}
+			alive[m] = FILTER_PARTICLES;
+		}
+	}
+
+	// Probability that any monster ends up within radius of (x, y)
+	double danger(int x, int y, int radius) const
+	{
+		double none = 1;
+		float r2 = (float)radius * radius;
+		for (int m = 0; m < count; m++)
+		{
+			int inside = 0;
+			for (int p = 0; p < FILTER_PARTICLES; p++)
+			{
+				float dx = px[m][p] - x;
+				float dy = py[m][p] - y;
+				inside += dx * dx + dy * dy <= r2;
+			}
+			none *= 1 - (double)inside / FILTER_PARTICLES;
+		}
+		return 1 - none;
+	}
+
+	// Mean of the particles of one monster within radius of (x, y), when
+	// at least a share threshold of them is there
+	bool nearby(int storeIdx, int x, int y, int radius, double threshold, double &mx, double &my, double &mvx, double &mvy) const
+	{
+		for (int m = 0; m < count; m++)
+		{
+			if (storeIndex[m] != storeIdx)
+				continue;
+			float r2 = (float)radius * radius;
+			int inside = 0;
+			mx = my = mvx = mvy = 0;
+			for (int p = 0; p < FILTER_PARTICLES; p++)
+			{
+				float dx = px[m][p] - x;
+				float dy = py[m][p] - y;
+				if (dx * dx + dy * dy > r2)
+					continue;
+				mx += px[m][p];
+				my += py[m][p];
+				mvx += pvx[m][p];
+				mvy += pvy[m][p];
+				inside++;
+			}
+			if (inside == 0 || inside < threshold * FILTER_PARTICLES)
+				return false;
+			mx /= inside;
+			my /= inside;
+			mvx /= inside;
+			mvy /= inside;
+			return true;
+		}
+		return false;
+	}
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef ENGINE_CONFIG_HPP
+#define ENGINE_CONFIG_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <map>
+#include <math.h>
+#include <set>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <stdint.h>
+#include <type_traits>
+#include <chrono>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#if defined(PROFILE) && defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+#define TOP_LIMIT 2500
+#define TOP_MIDDLE 3750
+#define MID_LIMIT 5000
+#define MID_MIDDLE 6250
+#define BOTTOM_LIMIT 7500
+#define BOTTOM_MIDDLE 8750
+
+#define LOW_LIGHT_RADIUS 800
+#define BIG_LIGHT_RADIUS 2000
+#define EMERGENCY_RADIUS 500
+#define DANGER_RADIUS 2300
+
+#define HEADING_RESOLUTION 360
+#define EVASION_MOVE 600
+#define EVASION_RADIUS (EMERGENCY_RADIUS + 100)
+
+// Spatial index cells: GRID_SIDE x GRID_SIDE over the map
+#define GRID_CELL 2000
+#define GRID_SIDE (MAP_SIZE / GRID_CELL)
+
+#define SIM_MAX_CREATURES 24
+#define LAST_TURN 200
+#define SIM_DRONES 4
+#define MAP_SIZE 10000
+#define DRONE_MOVE 600
+#define DRONE_SINK 300
+#define DRONE_EMERGENCY_RISE 300
+#define DRONE_MAX_BATTERY 30
+#define LIGHT_COST 5
+#define SURFACE_Y 500
+// Where the rule based strategies aim to save their scans
+#define SCAN_SAVE 490
+#define FISH_SPEED 200
+#define FISH_FLEE_SPEED 400
+#define FISH_HEARING_RADIUS 1400
+#define MONSTER_SPEED 270
+#define MONSTER_ATTACK_SPEED 540
+#define MONSTER_DETECTION_BONUS 300
+
+#define FISH_COLORS 4
+#define FISH_TYPES 3
+#define COLOR_COMBO_POINTS 3
+#define TYPE_COMBO_POINTS 4
+
+#define FILTER_MONSTERS 8
+#define FILTER_PARTICLES 128
+#define MONSTER_DANGER_THRESHOLD 0.1
+
+// Opponent drones: headings averaged over OPP_HISTORY positions and followed
+// for OPP_PREDICT_TURNS; a diving drone with scans turns back at OPP_TURN_DEPTH
+#define OPP_HISTORY 4
+#define OPP_PREDICT_TURNS 10
+#define OPP_TURN_DEPTH 8500
+
+// Turn decision: the hand written routine, or a search over SimState.
+// Replays record it, to be replayed by the same build
+#define STRATEGY_RULES 0
+#define STRATEGY_BEAM 1
+#define STRATEGY_MCTS 2
+#define STRATEGY_RHEA 3
+#ifndef STRATEGY
+#define STRATEGY STRATEGY_RULES
+#endif
+
+#define PLAN_MOVES 16
+// Share of the first-save bonuses the opponent's pending scans are expected to take
+#define RACE_RISK 0.5
+
+#define BEAM_WIDTH 24
+#define BEAM_DEPTH 6
+
+#define MCTS_NODES 20000
+#define MCTS_DEPTH 8
+#define MCTS_EXPLORATION 0.7
+
+#define RHEA_HORIZON 8
+#define RHEA_POPULATION 16
+#define RHEA_DISCOUNT 0.9
+
+// Time limits per turn; searches stop a margin early to leave room for output.
+// The first turn's margin also covers process start-up, which the referee counts.
+#define FIRST_TURN_BUDGET_MS 1000
+#define TURN_BUDGET_MS 50
+#define TURN_MARGIN_MS 10
+#define FIRST_TURN_MARGIN_MS 100
+// Searches stop this much before the deadline: evasion runs after them
+#define EVASION_RESERVE_MS 3
+
+// Build with -DPROFILE to time turn phases; records of the last PROFILE_TURNS
+// turns are kept and written every PROFILE_DUMP_TURNS turns
+#define PROFILE_TURNS 256
+#define PROFILE_DUMP_TURNS 20
+
+#define INPUT_BUFFER_SIZE 65536
+#define OUTPUT_BUFFER_SIZE 4096
+#define MAX_ENTITIES 64
+
+// Replay file header (see ReplayRecorder)
+#define REPLAY_MAGIC "FC23"
+#define REPLAY_VERSION 2
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef ENGINE_CREATURES_HPP
+#define ENGINE_CREATURES_HPP
+
+#include "grid.hpp"
+
+typedef enum
+{
+	LEFT,
+	RIGHT
+} CreatureSide;
+
+#define FLAG_VISIBLE 0
+#define FLAG_SAVED_BY_ME 1
+#define FLAG_SAVED_BY_OPP 2
+#define FLAG_SCANNED_BY_ME 3
+#define FLAG_SCANNED_BY_OPP 4
+#define FLAG_DEAD 5
+#define FLAG_SEEN 6
+#define FLAG_COUNT 7
+
+#define BIT(i) (1ULL << (i))
+
+// Creature state as parallel arrays, indexed in announcement order.
+// Each flag is a 64 bit mask over those indexes, as is each type (typeMask[type + 1]).
+class CreatureStore
+{
+public:
+	int count;
+	int id[MAX_ENTITIES];
+	int color[MAX_ENTITIES];
+	int type[MAX_ENTITIES];
+	int x[MAX_ENTITIES];
+	int y[MAX_ENTITIES];
+	int vx[MAX_ENTITIES];
+	int vy[MAX_ENTITIES];
+	CreatureSide side[MAX_ENTITIES];
+	uint64_t flags[FLAG_COUNT];
+	uint64_t typeMask[4];
+	// Visible creatures by position, rebuilt by indexVisible() each turn
+	SpatialGrid visibleGrid;
+
+	CreatureStore() : count(0)
+	{
+		for (int f = 0; f < FLAG_COUNT; f++)
+			flags[f] = 0;
+		for (int t = 0; t < 4; t++)
+			typeMask[t] = 0;
+		visibleGrid.clear();
+	}
+
+	int add(int id, int color, int type)
+	{
+		int i = count++;
+		this->id[i] = id;
+		this->color[i] = color;
+		this->type[i] = type;
+		this->x[i] = 0;
+		this->y[i] = 0;
+		this->vx[i] = 0;
+		this->vy[i] = 0;
+		this->side[i] = LEFT;
+		this->typeMask[type + 1] |= BIT(i);
+		return i;
+	}
+
+	uint64_t all() const
+	{
+		return count == 64 ? ~0ULL : BIT(count) - 1;
+	}
+
+	uint64_t monsters() const
+	{
+		return typeMask[0];
+	}
+
+	uint64_t fish() const
+	{
+		return typeMask[1] | typeMask[2] | typeMask[3];
+	}
+
+	uint64_t fish(int type) const
+	{
+		return typeMask[type + 1];
+	}
+
+	// Alive fish not scanned by me (saved fish count as scanned)
+	uint64_t unscanned(uint64_t candidates) const
+	{
+		return candidates & ~flags[FLAG_DEAD] & ~flags[FLAG_SCANNED_BY_ME];
+	}
+
+	void indexVisible()
+	{
+		visibleGrid.clear();
+		for (uint64_t m = flags[FLAG_VISIBLE]; m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			visibleGrid.insert(i, x[i], y[i]);
+		}
+	}
+
+	bool visibleMonsterWithin(int px, int py, int radius) const
+	{
+		for (uint64_t m = monsters() & flags[FLAG_VISIBLE] & visibleGrid.near(px, py, radius); m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			if (abs(x[i] - px) + abs(y[i] - py) <= radius)
+				return true;
+		}
+		return false;
+	}
+};
+
+// Thin view over one CreatureStore slot
+class Creature
+{
+public:
+	CreatureStore &store;
+	int index;
+	int &id;
+	int &color;
+	int &type;
+	int &x;
+	int &y;
+	int &dx;
+	int &dy;
+	CreatureSide &side;
+
+	Creature(CreatureStore &store, int index) : store(store), index(index), id(store.id[index]), color(store.color[index]), type(store.type[index]), x(store.x[index]), y(store.y[index]), dx(store.vx[index]), dy(store.vy[index]), side(store.side[index]) {}
+
+	bool operator==(const Creature &c)
+	{
+		return id == c.id;
+	}
+
+	bool has(int flag) { return (store.flags[flag] & BIT(index)) != 0; }
+	void set(int flag) { store.flags[flag] |= BIT(index); }
+	void clear(int flag) { store.flags[flag] &= ~BIT(index); }
+
+	bool isVisible() { return has(FLAG_VISIBLE); }
+	bool isSavedByMe() { return has(FLAG_SAVED_BY_ME); }
+	bool isSavedByOpp() { return has(FLAG_SAVED_BY_OPP); }
+	bool isScannedByMe() { return has(FLAG_SCANNED_BY_ME); }
+	bool isScannedByOpp() { return has(FLAG_SCANNED_BY_OPP); }
+	bool isDead() { return has(FLAG_DEAD); }
+
+	void update(int x, int y, int dx, int dy)
+	{
+		this->x = x;
+		this->y = y;
+		this->dx = dx;
+		this->dy = dy;
+		set(FLAG_VISIBLE);
+		set(FLAG_SEEN);
+	}
+
+	int distanceTo(int x, int y)
+	{
+		return abs(this->x - x) + abs(this->y - y);
+	}
+
+	int distanceTo(Creature &c)
+	{
+		return distanceTo(c.x, c.y);
+	}
+};
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef ENGINE_DRONE_HPP
+#define ENGINE_DRONE_HPP
+
+#include "io.hpp"
+#include "creatures.hpp"
+
+typedef enum
+{
+	MY_DRONE,
+	OPP_DRONE,
+} DroneOwner;
+
+class Drone
+{
+public:
+	int id;
+	int x;
+	int y;
+	int emergency;
+	int battery;
+	DroneOwner owner;
+	ActionManager &actionManager;
+	int moveX;
+	int moveY;
+	bool bigLight;
+	int scanCount;
+	// The light was on during the turn just read: the battery went down
+	bool lit;
+	uint64_t scans;
+	RadarDirection radarBlips[MAX_ENTITIES];
+	string actionMessage;
+
+	Drone(int id, int x, int y, int emergency, int battery, DroneOwner owner, ActionManager &actionManager) : actionManager(actionManager)
+	{
+		this->id = id;
+		this->x = x;
+		this->y = y;
+		this->emergency = emergency;
+		this->battery = battery;
+		this->owner = owner;
+		this->moveX = -1;
+		this->moveY = -1;
+		this->bigLight = false;
+		this->scanCount = 0;
+		this->lit = false;
+		this->scans = 0;
+		for (int i = 0; i < MAX_ENTITIES; i++)
+			this->radarBlips[i] = TOP_LEFT;
+		this->actionMessage = "";
+	}
+
+	Drone(const Drone &d) : actionManager(d.actionManager) { *this = d; }
+
+	Drone &operator=(const Drone &d)
+	{
+		id = d.id;
+		x = d.x;
+		y = d.y;
+		emergency = d.emergency;
+		battery = d.battery;
+		owner = d.owner;
+		moveX = d.moveX;
+		moveY = d.moveY;
+		bigLight = d.bigLight;
+		scanCount = d.scanCount;
+		lit = d.lit;
+		scans = d.scans;
+		for (int i = 0; i < MAX_ENTITIES; i++)
+			radarBlips[i] = d.radarBlips[i];
+		actionMessage = d.actionMessage;
+		return *this;
+	}
+
+	bool operator==(const Drone &d)
+	{
+		return id == d.id;
+	}
+
+	void update(int x, int y, int emergency, int battery)
+	{
+		this->lit = battery < this->battery;
+		this->x = x;
+		this->y = y;
+		this->emergency = emergency;
+		this->battery = battery;
+		this->moveX = -1;
+		this->moveY = -1;
+		this->bigLight = false;
+		this->actionMessage = "";
+		this->scans = 0;
+		this->scanCount = 0;
+	}
+
+	// Fish already saved by the drone's owner are not carried
+	void registerScan(Creature &c)
+	{
+		if (owner == MY_DRONE ? c.isSavedByMe() : c.isSavedByOpp())
+			return;
+		this->scans |= BIT(c.index);
+		this->scanCount = __builtin_popcountll(scans);
+	}
+
+	void move(int x, int y, string msg = "")
+	{
+		this->actionMessage = msg;
+		this->moveX = x;
+		this->moveY = y;
+	}
+
+	void move(Creature &c, string msg = "")
+	{
+		move(c.x, c.y, msg);
+	}
+
+	// To the map corner of a radar quadrant, or one radar step past the map
+	// edge when already within 300 of it (the referee clamps the move)
+	void moveToCorner(RadarDirection dir, string msg = "")
+	{
+		switch (dir)
+		{
+		case TOP_LEFT:
+			move(min(x - 300, 0), min(y - 300, 0), msg);
+			break;
+		case TOP_RIGHT:
+			move(max(x + 300, 10000), min(y - 300, 0), msg);
+			break;
+		case BOTTOM_LEFT:
+			move(min(x - 300, 0), max(y + 350, 10000), msg);
+			break;
+		case BOTTOM_RIGHT:
+			move(max(x + 300, 10000), max(y + 350, 10000), msg);
+			break;
+		}
+	}
+
+	void wait(string msg = "")
+	{
+		this->actionMessage = msg;
+		this->moveX = -1;
+		this->moveY = -1;
+	}
+
+	void setBigLight()
+	{
+		this->bigLight = true;
+	}
+
+	void setLowLight()
+	{
+		this->bigLight = false;
+	}
+
+	void toggleLight()
+	{
+		this->bigLight = !this->bigLight;
+	}
+
+	void registerActions()
+	{
+		if (moveX != -1 && moveY != -1)
+			actionManager.addMove(moveX, moveY, bigLight, actionMessage);
+		else
+			actionManager.addWait(bigLight, actionMessage);
+	}
+
+	int distanceTo(int x, int y)
+	{
+		return abs(this->x - x) + abs(this->y - y);
+	}
+
+	int distanceTo(Creature &c)
+	{
+		return distanceTo(c.x, c.y);
+	}
+
+	int distanceTo(Drone &d)
+	{
+		return distanceTo(d.x, d.y);
+	}
+
+	int distanceTo(Creature *c)
+	{
+		return distanceTo(c->x, c->y);
+	}
+
+	pair<int, int> getTarget()
+	{
+		if (moveX != -1 && moveY != -1)
+			return make_pair(moveX, moveY);
+		else
+			return make_pair(x, y);
+	}
+
+	~Drone() {}
+};
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef ENGINE_EVASION_HPP
+#define ENGINE_EVASION_HPP
+
+#include "geometry.hpp"
+#include "creatures.hpp"
+
+// Heading search used by Game::protectionMode.
+// A heading is unsafe when the drone, moving linearly along it for the whole turn,
+// gets within EVASION_RADIUS of a monster moving linearly along its own speed.
+// Relative motion is r(t) = (D - M) + (V - W) t, whose closest approach over t in [0, 1]
+// is at t = -(r0.u) / (u.u) clamped, so each monster costs one evaluation.
+// With AVX2 four headings are tested at once.
+class EvasionKernel
+{
+	int monsterCount;
+	double monsterX[MAX_ENTITIES];
+	double monsterY[MAX_ENTITIES];
+	double monsterVX[MAX_ENTITIES];
+	double monsterVY[MAX_ENTITIES];
+	double moveX[HEADING_RESOLUTION];
+	double moveY[HEADING_RESOLUTION];
+	bool safe[HEADING_RESOLUTION];
+
+	bool isSafe(int x, int y, double mx, double my)
+	{
+		for (int m = 0; m < monsterCount; m++)
+		{
+			double rx = x - monsterX[m];
+			double ry = y - monsterY[m];
+			double ux = mx - monsterVX[m];
+			double uy = my - monsterVY[m];
+			double uu = ux * ux + uy * uy;
+			double t = uu > 0 ? min(1.0, max(0.0, -(rx * ux + ry * uy) / uu)) : 0;
+			double dx = rx + ux * t;
+			double dy = ry + uy * t;
+			if (dx * dx + dy * dy < EVASION_RADIUS * EVASION_RADIUS)
+				return false;
+		}
+		return true;
+	}
+
+	void markSafeHeadings(int x, int y)
+	{
+		int h = 0;
+#ifdef __AVX2__
+		const __m256d zero = _mm256_setzero_pd();
+		const __m256d one = _mm256_set1_pd(1);
+		const __m256d radius = _mm256_set1_pd(EVASION_RADIUS * EVASION_RADIUS);
+		for (; h + 4 <= HEADING_RESOLUTION; h += 4)
+		{
+			__m256d mx = _mm256_loadu_pd(moveX + h);
+			__m256d my = _mm256_loadu_pd(moveY + h);
+			__m256d danger = zero;
+			for (int m = 0; m < monsterCount; m++)
+			{
+				__m256d rx = _mm256_set1_pd(x - monsterX[m]);
+				__m256d ry = _mm256_set1_pd(y - monsterY[m]);
+				__m256d ux = _mm256_sub_pd(mx, _mm256_set1_pd(monsterVX[m]));
+				__m256d uy = _mm256_sub_pd(my, _mm256_set1_pd(monsterVY[m]));
+				__m256d dot = _mm256_add_pd(_mm256_mul_pd(rx, ux), _mm256_mul_pd(ry, uy));
+				__m256d uu = _mm256_add_pd(_mm256_mul_pd(ux, ux), _mm256_mul_pd(uy, uy));
+				// 0 / 0 gives NaN, which max() turns into 0 like the scalar path
+				__m256d t = _mm256_min_pd(_mm256_max_pd(_mm256_div_pd(_mm256_sub_pd(zero, dot), uu), zero), one);
+				__m256d dx = _mm256_add_pd(rx, _mm256_mul_pd(ux, t));
+				__m256d dy = _mm256_add_pd(ry, _mm256_mul_pd(uy, t));
+				__m256d dist = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+				danger = _mm256_or_pd(danger, _mm256_cmp_pd(dist, radius, _CMP_LT_OQ));
+			}
+			int mask = _mm256_movemask_pd(danger);
+			for (int j = 0; j < 4; j++)
+				safe[h + j] = !(mask & (1 << j));
+		}
+#endif
+		for (; h < HEADING_RESOLUTION; h++)
+			safe[h] = isSafe(x, y, moveX[h], moveY[h]);
+	}
+
+public:
+	EvasionKernel() : monsterCount(0) {}
+
+	void clearMonsters()
+	{
+		monsterCount = 0;
+	}
+
+	void addMonster(double x, double y, double vx, double vy)
+	{
+		if (monsterCount == MAX_ENTITIES)
+			return;
+		monsterX[monsterCount] = x;
+		monsterY[monsterCount] = y;
+		monsterVX[monsterCount] = vx;
+		monsterVY[monsterCount] = vy;
+		monsterCount++;
+	}
+
+	void setMonsters(CreatureStore &store)
+	{
+		clearMonsters();
+		for (uint64_t m = store.monsters(); m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			addMonster(store.x[i], store.y[i], store.vx[i], store.vy[i]);
+		}
+	}
+
+	// Safe move closest to the target among the rotations of the drone->target
+	// direction; the target itself, and false, when no heading is safe
+	bool bestMove(int x, int y, int targetX, int targetY, int &bestX, int &bestY)
+	{
+		bestX = targetX;
+		bestY = targetY;
+		double vx = targetX - x;
+		double vy = targetY - y;
+		double norm = sqrt(vx * vx + vy * vy);
+		if (norm == 0)
+		{
+			vx = 0;
+			vy = -1;
+		}
+		else
+		{
+			vx /= norm;
+			vy /= norm;
+		}
+		for (int i = 0; i < HEADING_RESOLUTION; i++)
+		{
+			moveX[i] = (int)((vx * HEADINGS.x[i] - vy * HEADINGS.y[i]) * EVASION_MOVE);
+			moveY[i] = (int)((vx * HEADINGS.y[i] + vy * HEADINGS.x[i]) * EVASION_MOVE);
+		}
+		markSafeHeadings(x, y);
+
+		int minDistance = 1000000;
+		bool found = false;
+		for (int i = 0; i < HEADING_RESOLUTION; i++)
+		{
+			if (!safe[i])
+				continue;
+			int mx = moveX[i];
+			int my = moveY[i];
+			int distance = sqrt((x + mx - targetX) * (x + mx - targetX) + (y + my - targetY) * (y + my - targetY));
+			if (distance < minDistance)
+			{
+				minDistance = distance;
+				bestX = x + mx;
+				bestY = y + my;
+				found = true;
+			}
+		}
+		return found;
+	}
+};
+
+#endif
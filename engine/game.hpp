@@ -0,0 +1,538 @@
+#ifndef ENGINE_GAME_HPP
+#define ENGINE_GAME_HPP
+
+#include "io.hpp"
+#include "timing.hpp"
+#include "creatures.hpp"
+#include "drone.hpp"
+#include "sim.hpp"
+#include "belief.hpp"
+#include "opponent.hpp"
+
+// Plain copy of one drone; creatures are referenced by store index
+class DroneSnapshot
+{
+public:
+	int id;
+	int x;
+	int y;
+	int emergency;
+	int battery;
+	DroneOwner owner;
+	bool lit;
+	uint64_t scans;
+	unsigned char radarBlips[MAX_ENTITIES];
+};
+
+// Everything parsed from the referee, without pointers: branch it with a memcpy
+class GameSnapshot
+{
+public:
+	int turn;
+	int myScore;
+	int oppScore;
+	int myDroneCount;
+	int oppDroneCount;
+	CreatureStore creatures;
+	BeliefTracker beliefs;
+	MonsterFilter monsterFilter;
+	OpponentPredictor opponents;
+	DroneSnapshot drones[SIM_DRONES];
+};
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "snapshots are copied with memcpy");
+
+// Everything the referee tells the bot, kept up to date turn by turn.
+// A strategy derives from it and implements decide().
+class GameState
+{
+public:
+	int turn;
+	int creatureCount;
+	CreatureStore creatureStore;
+	vector<Creature> creatures;
+	int myScore;
+	int oppScore;
+	int mySavedScanCount;
+	vector<Creature *> mySavedScans;
+	int oppSavedScanCount;
+	vector<Creature *> oppSavedScans;
+	int myDroneCount;
+	vector<Drone> myDrones;
+	int oppDroneCount;
+	vector<Drone> oppDrones;
+	int visibleCreatureCount;
+	vector<Creature *> visibleCreatures;
+	int myScanCount;
+	vector<Creature *> myScans;
+	vector<Creature *> monsters;
+
+	// Entity ids are small integers: direct lookup tables, nullptr for unknown ids
+	Creature *creatureById[MAX_ENTITIES];
+	Drone *droneById[MAX_ENTITIES];
+
+	ActionManager actionManager;
+	InputReader input;
+	BeliefTracker beliefs;
+	MonsterFilter monsterFilter;
+	OpponentPredictor opponents;
+	SaveScorer scorer;
+	TurnTimer timer;
+	ReplayRecorder recorder;
+	GameState() : turn(0), creatureCount(0)
+	{
+		recorder.open(getenv("REPLAY_FILE"), input, actionManager);
+		initParse();
+	}
+	GameState(const InputReader &source) : turn(0), creatureCount(0), input(source) { initParse(); }
+	GameState(const GameState &g) = delete;
+	virtual ~GameState() {}
+	GameState &operator=(const GameState &g) = delete;
+
+	GameSnapshot snapshot() const
+	{
+		GameSnapshot snap = GameSnapshot();
+		snap.turn = turn;
+		snap.myScore = myScore;
+		snap.oppScore = oppScore;
+		snap.myDroneCount = min((int)myDrones.size(), SIM_DRONES / 2);
+		snap.oppDroneCount = min((int)oppDrones.size(), SIM_DRONES / 2);
+		snap.creatures = creatureStore;
+		snap.beliefs = beliefs;
+		snap.monsterFilter = monsterFilter;
+		snap.opponents = opponents;
+		for (int k = 0; k < snap.myDroneCount + snap.oppDroneCount; k++)
+		{
+			const Drone &d = k < snap.myDroneCount ? myDrones[k] : oppDrones[k - snap.myDroneCount];
+			DroneSnapshot &ds = snap.drones[k];
+			ds.id = d.id;
+			ds.x = d.x;
+			ds.y = d.y;
+			ds.emergency = d.emergency;
+			ds.battery = d.battery;
+			ds.owner = d.owner;
+			ds.lit = d.lit;
+			ds.scans = d.scans;
+			for (int i = 0; i < MAX_ENTITIES; i++)
+				ds.radarBlips[i] = d.radarBlips[i];
+		}
+		return snap;
+	}
+
+	// Drone actions are reset; pointer views are rebuilt from the flag masks
+	void restore(const GameSnapshot &snap)
+	{
+		turn = snap.turn;
+		myScore = snap.myScore;
+		oppScore = snap.oppScore;
+		bool sameCreatures = creatureStore.count == snap.creatures.count;
+		creatureStore = snap.creatures;
+		beliefs = snap.beliefs;
+		monsterFilter = snap.monsterFilter;
+		opponents = snap.opponents;
+		creatureCount = creatureStore.count;
+		if (!sameCreatures)
+			buildCreatureViews();
+		myDroneCount = snap.myDroneCount;
+		oppDroneCount = snap.oppDroneCount;
+		myDrones.clear();
+		oppDrones.clear();
+		myDrones.reserve(myDroneCount);
+		oppDrones.reserve(oppDroneCount);
+		for (int k = 0; k < myDroneCount + oppDroneCount; k++)
+		{
+			const DroneSnapshot &ds = snap.drones[k];
+			vector<Drone> &drones = k < myDroneCount ? myDrones : oppDrones;
+			drones.push_back(Drone(ds.id, ds.x, ds.y, ds.emergency, ds.battery, ds.owner, actionManager));
+			Drone &d = drones.back();
+			d.lit = ds.lit;
+			d.scans = ds.scans;
+			d.scanCount = __builtin_popcountll(ds.scans);
+			for (int i = 0; i < MAX_ENTITIES; i++)
+				d.radarBlips[i] = (RadarDirection)ds.radarBlips[i];
+		}
+		indexEntities();
+		collectViews();
+	}
+
+	void collectViews()
+	{
+		CreatureStore &s = creatureStore;
+		mySavedScans.clear();
+		oppSavedScans.clear();
+		visibleCreatures.clear();
+		myScans.clear();
+		for (uint64_t m = s.flags[FLAG_SAVED_BY_ME]; m; m &= m - 1)
+			mySavedScans.push_back(&creatures[__builtin_ctzll(m)]);
+		for (uint64_t m = s.flags[FLAG_SAVED_BY_OPP]; m; m &= m - 1)
+			oppSavedScans.push_back(&creatures[__builtin_ctzll(m)]);
+		for (uint64_t m = s.flags[FLAG_VISIBLE]; m; m &= m - 1)
+			visibleCreatures.push_back(&creatures[__builtin_ctzll(m)]);
+		for (uint64_t m = s.flags[FLAG_SCANNED_BY_ME] & ~s.flags[FLAG_SAVED_BY_ME]; m; m &= m - 1)
+			myScans.push_back(&creatures[__builtin_ctzll(m)]);
+		mySavedScanCount = mySavedScans.size();
+		oppSavedScanCount = oppSavedScans.size();
+		visibleCreatureCount = visibleCreatures.size();
+		myScanCount = myScans.size();
+	}
+
+	void buildCreatureViews()
+	{
+		creatures.clear();
+		monsters.clear();
+		creatures.reserve(creatureStore.count);
+		for (int i = 0; i < creatureStore.count; i++)
+			creatures.push_back(Creature(creatureStore, i));
+		for (auto &c : creatures)
+		{
+			if (c.type < 0)
+				monsters.push_back(&c);
+		}
+	}
+
+	void initParse()
+	{
+		creatureCount = input.readInt();
+		for (int i = 0; i < creatureCount; i++)
+		{
+			int creature_id = input.readInt();
+			int color = input.readInt();
+			int type = input.readInt();
+			creatureStore.add(creature_id, color, type);
+		}
+		buildCreatureViews();
+		indexEntities();
+		beliefs.reset(creatureStore);
+		monsterFilter.reset(creatureStore, beliefs);
+		scorer.setup(creatureStore, creatureStore.all());
+	}
+
+	// Unsaved scans of the opponent's drones expected to surface in at least the given turns
+	uint64_t oppPending(int turns) const
+	{
+		uint64_t pending = 0;
+		for (int k = 0; k < (int)oppDrones.size(); k++)
+		{
+			int surface = opponents.surfaceIn(k);
+			if (surface >= turns)
+				pending |= oppDrones[k].scans;
+		}
+		return pending & ~creatureStore.flags[FLAG_SAVED_BY_OPP];
+	}
+
+	// Points the scans of d would lose to opponent drones it can still beat to the surface
+	int raceRisk(const Drone &d) const
+	{
+		const CreatureStore &s = creatureStore;
+		int turns = OpponentPredictor::turnsToRise(d.y, DRONE_MOVE);
+		return scorer.race(d.scans, s.flags[FLAG_SAVED_BY_ME], s.flags[FLAG_SAVED_BY_OPP], oppPending(turns));
+	}
+
+	void indexEntities()
+	{
+		for (int i = 0; i < MAX_ENTITIES; i++)
+		{
+			creatureById[i] = nullptr;
+			droneById[i] = nullptr;
+		}
+		for (auto &c : creatures)
+		{
+			if (c.id >= 0 && c.id < MAX_ENTITIES)
+				creatureById[c.id] = &c;
+		}
+		for (auto &d : myDrones)
+		{
+			if (d.id >= 0 && d.id < MAX_ENTITIES)
+				droneById[d.id] = &d;
+		}
+		for (auto &d : oppDrones)
+		{
+			if (d.id >= 0 && d.id < MAX_ENTITIES)
+				droneById[d.id] = &d;
+		}
+	}
+
+	Creature *getCreatureById(int id)
+	{
+		if (id < 0 || id >= MAX_ENTITIES)
+			return nullptr;
+		return creatureById[id];
+	}
+
+	Drone *getDroneById(int id)
+	{
+		if (id < 0 || id >= MAX_ENTITIES)
+			return nullptr;
+		return droneById[id];
+	}
+
+	// Creatures out of sight are placed at the middle of their belief box,
+	// standing still; monsters never seen are left out.
+	SimState simulationState()
+	{
+		SimState sim;
+		CreatureStore &s = creatureStore;
+		sim.turn = turn;
+		sim.creatureCount = min(s.count, SIM_MAX_CREATURES);
+		sim.fish = s.fish() & (BIT(sim.creatureCount) - 1);
+		sim.monsters = s.monsters() & s.flags[FLAG_SEEN] & (BIT(sim.creatureCount) - 1);
+		sim.lost = s.flags[FLAG_DEAD];
+		sim.savedByMe = s.flags[FLAG_SAVED_BY_ME];
+		sim.savedByOpp = s.flags[FLAG_SAVED_BY_OPP];
+		sim.myScore = myScore;
+		sim.oppScore = oppScore;
+		sim.scorer.setup(s, BIT(sim.creatureCount) - 1);
+		for (int i = 0; i < sim.creatureCount; i++)
+		{
+			sim.type[i] = s.type[i];
+			sim.x[i] = s.x[i];
+			sim.y[i] = s.y[i];
+			sim.vx[i] = s.vx[i];
+			sim.vy[i] = s.vy[i];
+			if (!(s.flags[FLAG_VISIBLE] & BIT(i)))
+			{
+				sim.x[i] = beliefs.estimateX(i);
+				sim.y[i] = beliefs.estimateY(i);
+				sim.vx[i] = 0;
+				sim.vy[i] = 0;
+			}
+		}
+		int k = 0;
+		for (auto *drones : {&myDrones, &oppDrones})
+		{
+			for (auto &d : *drones)
+			{
+				if (k >= SIM_DRONES)
+					break;
+				SimDrone &sd = sim.drones[k++];
+				sd.x = d.x;
+				sd.y = d.y;
+				sd.battery = d.battery;
+				sd.emergency = d.emergency != 0;
+				sd.light = false;
+				sd.scans = d.scans & (BIT(sim.creatureCount) - 1);
+			}
+		}
+		for (; k < SIM_DRONES; k++)
+			sim.drones[k] = SimDrone();
+		sim.index();
+		return sim;
+	}
+
+	void turnParse()
+	{
+		myScore = input.readInt();
+		oppScore = input.readInt();
+
+		creatureStore.flags[FLAG_SCANNED_BY_ME] = 0;
+
+		mySavedScanCount = input.readInt();
+		for (int i = 0; i < mySavedScanCount; i++)
+		{
+			Creature *c = getCreatureById(input.readInt());
+			if (c == nullptr || c->isSavedByMe())
+				continue;
+			c->set(FLAG_SAVED_BY_ME);
+			mySavedScans.push_back(c);
+		}
+
+		oppSavedScanCount = input.readInt();
+		for (int i = 0; i < oppSavedScanCount; i++)
+		{
+			Creature *c = getCreatureById(input.readInt());
+			if (c == nullptr || c->isSavedByOpp())
+				continue;
+			c->set(FLAG_SAVED_BY_OPP);
+			oppSavedScans.push_back(c);
+		}
+
+		myDroneCount = input.readInt();
+		if (turn == 0)
+			myDrones.reserve(myDroneCount);
+		for (int i = 0; i < myDroneCount; i++)
+		{
+			int drone_id = input.readInt();
+			int drone_x = input.readInt();
+			int drone_y = input.readInt();
+			int emergency = input.readInt();
+			int battery = input.readInt();
+			if (turn == 0)
+				myDrones.push_back(Drone(drone_id, drone_x, drone_y, emergency, battery, MY_DRONE, this->actionManager));
+			else if (Drone *d = getDroneById(drone_id))
+				d->update(drone_x, drone_y, emergency, battery);
+		}
+
+		oppDroneCount = input.readInt();
+		if (turn == 0)
+			oppDrones.reserve(oppDroneCount);
+		for (int i = 0; i < oppDroneCount; i++)
+		{
+			int drone_id = input.readInt();
+			int drone_x = input.readInt();
+			int drone_y = input.readInt();
+			int emergency = input.readInt();
+			int battery = input.readInt();
+			if (turn == 0)
+				oppDrones.push_back(Drone(drone_id, drone_x, drone_y, emergency, battery, OPP_DRONE, this->actionManager));
+			else if (Drone *d = getDroneById(drone_id))
+				d->update(drone_x, drone_y, emergency, battery);
+		}
+
+		if (turn == 0)
+			indexEntities();
+
+		int drone_scan_count = input.readInt();
+		myScans.clear();
+		for (int i = 0; i < drone_scan_count; i++)
+		{
+			int drone_id = input.readInt();
+			int creature_id = input.readInt();
+			Creature *c = getCreatureById(creature_id);
+			Drone *d = getDroneById(drone_id);
+			if (c == nullptr || d == nullptr)
+				continue;
+			if (d->owner == MY_DRONE)
+			{
+				if (!c->isScannedByMe())
+					myScans.push_back(c);
+				c->set(FLAG_SCANNED_BY_ME);
+			}
+			else
+			{
+				c->set(FLAG_SCANNED_BY_OPP);
+			}
+			d->registerScan(*c);
+		}
+		myScanCount = myScans.size();
+
+		creatureStore.flags[FLAG_VISIBLE] = 0;
+		visibleCreatureCount = input.readInt();
+		visibleCreatures.clear();
+		for (int i = 0; i < visibleCreatureCount; i++)
+		{
+			int creature_id = input.readInt();
+			int creature_x = input.readInt();
+			int creature_y = input.readInt();
+			int creature_vx = input.readInt();
+			int creature_vy = input.readInt();
+			// cerr << "Creature " << creature_id << " (" << getCreatureById(creature_id)->type << ") is visible" << endl;
+			Creature *c = getCreatureById(creature_id);
+			if (c == nullptr)
+				continue;
+			c->update(creature_x, creature_y, creature_vx, creature_vy);
+			visibleCreatures.push_back(c);
+		}
+		creatureStore.indexVisible();
+
+		int radar_blip_count = input.readInt();
+		uint64_t alive = 0;
+		for (int i = 0; i < radar_blip_count; i++)
+		{
+			int drone_id = input.readInt();
+			int creature_id = input.readInt();
+			RadarDirection dir = input.readRadar();
+			Drone *d = getDroneById(drone_id);
+			Creature *c = getCreatureById(creature_id);
+			if (d == nullptr || c == nullptr)
+				continue;
+			d->radarBlips[creature_id] = dir;
+			alive |= BIT(c->index);
+		}
+
+		creatureStore.flags[FLAG_DEAD] |= creatureStore.all() & ~alive;
+		creatureStore.flags[FLAG_SCANNED_BY_ME] |= creatureStore.flags[FLAG_SAVED_BY_ME];
+	}
+
+	// What the bot infers from the turn just parsed: creature beliefs, monster
+	// particles and opponent tracks. Called after turnParse(), before turn++
+	void updateModels()
+	{
+		beliefs.predict(creatureStore);
+		for (auto &d : myDrones)
+			beliefs.cut(creatureStore, d.x, d.y, d.radarBlips);
+
+		monsterFilter.predict(creatureStore);
+		for (auto &d : myDrones)
+			monsterFilter.observe(creatureStore, d.x, d.y, (d.lit ? BIG_LIGHT_RADIUS : LOW_LIGHT_RADIUS) + MONSTER_DETECTION_BONUS, d.radarBlips);
+		monsterFilter.resample(creatureStore, beliefs);
+
+		opponents.update(oppDrones, turn == 0);
+	}
+
+	// Sets the drones' moves for the turn just parsed
+	virtual void decide() = 0;
+
+	void play()
+	{
+		input.waitForInput();
+		if (turn == 0)
+			timer.start(FIRST_TURN_BUDGET_MS, FIRST_TURN_MARGIN_MS);
+		else
+			timer.start(TURN_BUDGET_MS, TURN_MARGIN_MS);
+		PROFILE_TURN(turn + 1);
+		{
+			PROFILE_SCOPE(PROFILE_PARSE);
+			turnParse();
+		}
+		{
+			PROFILE_SCOPE(PROFILE_MODELS);
+			updateModels();
+		}
+		turn++;
+		{
+			PROFILE_SCOPE(PROFILE_DECIDE);
+			decide();
+		}
+		{
+			PROFILE_SCOPE(PROFILE_OUTPUT);
+			for (auto &d : myDrones)
+				d.registerActions();
+			actionManager.execute();
+		}
+		if (recorder.active())
+			recorder.frame(turn, input);
+		PROFILE_END_TURN(turn);
+		timer.report(turn);
+	}
+
+	int countAliveFish()
+	{
+		return __builtin_popcountll(creatureStore.fish() & ~creatureStore.flags[FLAG_DEAD]);
+	}
+
+	int countAliveFish(int type)
+	{
+		return __builtin_popcountll(creatureStore.fish(type) & ~creatureStore.flags[FLAG_DEAD]);
+	}
+
+	bool areAllFishScanned(int type)
+	{
+		return creatureStore.unscanned(creatureStore.fish(type)) == 0;
+	}
+
+	bool areAllFishScanned()
+	{
+		return creatureStore.unscanned(creatureStore.fish()) == 0;
+	}
+
+	int missingScan(int type)
+	{
+		return __builtin_popcountll(creatureStore.unscanned(creatureStore.fish(type)));
+	}
+
+	void detectSides()
+	{
+		Drone *ref = &myDrones.front();
+		if (abs(ref->x - 5000) > abs(myDrones.back().x - 5000))
+			ref = &myDrones.back();
+		for (auto &c : creatures)
+		{
+			if (ref->radarBlips[c.id] == TOP_LEFT || ref->radarBlips[c.id] == BOTTOM_LEFT)
+				c.side = LEFT;
+			else
+				c.side = RIGHT;
+		}
+	}
+};
+
+#endif
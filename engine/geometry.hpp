@@ -0,0 +1,56 @@
+#ifndef ENGINE_GEOMETRY_HPP
+#define ENGINE_GEOMETRY_HPP
+
+#include "config.hpp"
+
+typedef enum
+{
+	TOP_LEFT,
+	TOP_RIGHT,
+	BOTTOM_LEFT,
+	BOTTOM_RIGHT,
+} RadarDirection;
+
+// std::sin/std::cos are not usable in constant expressions
+constexpr double constexprSin(double angle)
+{
+	while (angle > M_PI)
+		angle -= 2 * M_PI;
+	while (angle < -M_PI)
+		angle += 2 * M_PI;
+	double term = angle;
+	double sum = angle;
+	for (int n = 1; n < 16; n++)
+	{
+		term *= -angle * angle / ((2 * n) * (2 * n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double constexprCos(double angle)
+{
+	return constexprSin(angle + M_PI / 2);
+}
+
+// Unit vectors for HEADING_RESOLUTION evenly spaced headings, heading 0 pointing right.
+// The map y axis points down, so heading angles turn clockwise on screen.
+class HeadingTable
+{
+public:
+	double x[HEADING_RESOLUTION];
+	double y[HEADING_RESOLUTION];
+
+	constexpr HeadingTable() : x(), y()
+	{
+		for (int i = 0; i < HEADING_RESOLUTION; i++)
+		{
+			x[i] = constexprCos(2 * M_PI * i / HEADING_RESOLUTION);
+			y[i] = constexprSin(2 * M_PI * i / HEADING_RESOLUTION);
+		}
+	}
+};
+
+constexpr HeadingTable HEADINGS;
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef ENGINE_GRID_HPP
+#define ENGINE_GRID_HPP
+
+#include "config.hpp"
+
+// Uniform grid over the map, GRID_CELL units a side, stored by bands: the
+// mask of creature indexes in each column and in each row. A cell is the
+// intersection of its row and column, so near() gets everything in the cells
+// a square around a point overlaps from two small ORs: a superset of any
+// radius query, that callers refine with their exact distance test. Keeping
+// bands instead of cells keeps the grid small enough to copy with SimState.
+class SpatialGrid
+{
+public:
+	uint64_t columns[GRID_SIDE];
+	uint64_t rows[GRID_SIDE];
+
+	static int band(int v)
+	{
+		return min(max(v, 0), MAP_SIZE - 1) / GRID_CELL;
+	}
+
+	void clear()
+	{
+		for (int b = 0; b < GRID_SIDE; b++)
+		{
+			columns[b] = 0;
+			rows[b] = 0;
+		}
+	}
+
+	void insert(int i, int x, int y)
+	{
+		columns[band(x)] |= 1ULL << i;
+		rows[band(y)] |= 1ULL << i;
+	}
+
+	void remove(int i, int x, int y)
+	{
+		columns[band(x)] &= ~(1ULL << i);
+		rows[band(y)] &= ~(1ULL << i);
+	}
+
+	void move(int i, int fromX, int fromY, int toX, int toY)
+	{
+		int from = band(fromX);
+		int to = band(toX);
+		if (from != to)
+		{
+			columns[from] &= ~(1ULL << i);
+			columns[to] |= 1ULL << i;
+		}
+		from = band(fromY);
+		to = band(toY);
+		if (from != to)
+		{
+			rows[from] &= ~(1ULL << i);
+			rows[to] |= 1ULL << i;
+		}
+	}
+
+	// Indexes possibly within radius of (x, y), Euclidean or Manhattan
+	uint64_t near(int x, int y, int radius) const
+	{
+		uint64_t inColumns = 0;
+		uint64_t inRows = 0;
+		for (int b = band(x - radius); b <= band(x + radius); b++)
+			inColumns |= columns[b];
+		for (int b = band(y - radius); b <= band(y + radius); b++)
+			inRows |= rows[b];
+		return inColumns & inRows;
+	}
+};
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef ENGINE_IO_HPP
+#define ENGINE_IO_HPP
+
+#include "geometry.hpp"
+
+class ActionManager
+{
+	char buffer[OUTPUT_BUFFER_SIZE];
+	int len;
+
+public:
+	// Where commands go, -1 to drop them; a copy is appended to capture when set
+	int fd;
+	string *capture;
+
+private:
+
+	void writeChar(char c)
+	{
+		if (len < OUTPUT_BUFFER_SIZE)
+			buffer[len++] = c;
+	}
+
+	void writeInt(int value)
+	{
+		char digits[12];
+		int count = 0;
+		if (value < 0)
+		{
+			writeChar('-');
+			value = -value;
+		}
+		do
+		{
+			digits[count++] = '0' + value % 10;
+			value /= 10;
+		} while (value > 0);
+		while (count > 0)
+			writeChar(digits[--count]);
+	}
+
+	void writeEnd(bool bigLight, const string &msg)
+	{
+		writeChar(' ');
+		writeChar(bigLight ? '1' : '0');
+		if (msg.length() > 0)
+		{
+			writeChar(' ');
+			for (char c : msg)
+				writeChar(c);
+		}
+		writeChar('\n');
+	}
+
+public:
+	ActionManager() : len(0), fd(1), capture(nullptr) {}
+
+	void addMove(int x, int y, bool bigLight, const string &msg)
+	{
+		writeChar('M');
+		writeChar('O');
+		writeChar('V');
+		writeChar('E');
+		writeChar(' ');
+		writeInt(x);
+		writeChar(' ');
+		writeInt(y);
+		writeEnd(bigLight, msg);
+	}
+
+	void addWait(bool bigLight, const string &msg)
+	{
+		writeChar('W');
+		writeChar('A');
+		writeChar('I');
+		writeChar('T');
+		writeEnd(bigLight, msg);
+	}
+
+	// One write per turn: the referee wakes up once, with every drone command
+	void execute()
+	{
+		if (capture != nullptr)
+			capture->append(buffer, len);
+		int done = fd < 0 ? len : 0;
+		while (done < len)
+		{
+			int n = write(fd, buffer + done, len - done);
+			if (n <= 0)
+				break;
+			done += n;
+		}
+		len = 0;
+	}
+};
+
+// Reads a file descriptor, or a memory block when fd is -1
+class InputReader
+{
+	char buffer[INPUT_BUFFER_SIZE];
+	int pos;
+	int len;
+	int fd;
+	const char *source;
+	int sourceLen;
+	int sourcePos;
+
+	bool refill()
+	{
+		pos = 0;
+		if (fd >= 0)
+			len = read(fd, buffer, INPUT_BUFFER_SIZE);
+		else
+		{
+			len = min(sourceLen - sourcePos, INPUT_BUFFER_SIZE);
+			memcpy(buffer, source + sourcePos, len);
+			sourcePos += len;
+		}
+		if (len < 0)
+			len = 0;
+		if (capture != nullptr)
+			capture->append(buffer, len);
+		return len > 0;
+	}
+
+	int next()
+	{
+		if (pos == len && !refill())
+			return -1;
+		return buffer[pos++];
+	}
+
+	int skipBlanks()
+	{
+		int ch = next();
+		while (ch == ' ' || ch == '\n' || ch == '\r')
+			ch = next();
+		// The referee closed the pipe: the game is over
+		if (ch == -1)
+			exit(0);
+		return ch;
+	}
+
+public:
+	// Every byte read is appended here when set
+	string *capture;
+
+	InputReader(int fd = 0) : pos(0), len(0), fd(fd), source(nullptr), sourceLen(0), sourcePos(0), capture(nullptr) {}
+	InputReader(const char *data, int size) : pos(0), len(0), fd(-1), source(data), sourceLen(size), sourcePos(0), capture(nullptr) {}
+
+	// Bytes already read but not parsed yet
+	int pending() const
+	{
+		return len - pos;
+	}
+
+	// Blocks until the next turn's input starts arriving, without consuming it
+	void waitForInput()
+	{
+		skipBlanks();
+		pos--;
+	}
+
+	int readInt()
+	{
+		int ch = skipBlanks();
+		bool negative = ch == '-';
+		if (negative)
+			ch = next();
+		int value = 0;
+		while (ch >= '0' && ch <= '9')
+		{
+			value = value * 10 + ch - '0';
+			ch = next();
+		}
+		return negative ? -value : value;
+	}
+
+	RadarDirection readRadar()
+	{
+		int vertical = skipBlanks();
+		int horizontal = next();
+		if (vertical == 'T')
+			return horizontal == 'L' ? TOP_LEFT : TOP_RIGHT;
+		return horizontal == 'L' ? BOTTOM_LEFT : BOTTOM_RIGHT;
+	}
+};
+
+// Replay files: REPLAY_MAGIC, varints REPLAY_VERSION and the bot's STRATEGY,
+// then one frame per turn, each a varint turn number, the varint length and
+// bytes of the input consumed during the turn, and the varint length and
+// bytes of the commands written.
+inline void writeVarint(string &out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out += (char)(value | 0x80);
+		value >>= 7;
+	}
+	out += (char)value;
+}
+
+inline bool readVarint(const string &in, size_t &pos, uint64_t &value)
+{
+	value = 0;
+	for (int shift = 0; pos < in.size() && shift < 64; shift += 7)
+	{
+		unsigned char byte = in[pos++];
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+// Tees the bot's input and output into a replay file, one frame per turn.
+// Inactive unless open() gets a path.
+class ReplayRecorder
+{
+	int fd;
+	string input;
+	string output;
+
+public:
+	ReplayRecorder() : fd(-1) {}
+
+	bool active() const
+	{
+		return fd >= 0;
+	}
+
+	void open(const char *path, InputReader &reader, ActionManager &actions)
+	{
+		if (path == nullptr || *path == 0)
+			return;
+		fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (fd < 0)
+			return;
+		reader.capture = &input;
+		actions.capture = &output;
+		string header = REPLAY_MAGIC;
+		writeVarint(header, REPLAY_VERSION);
+		writeVarint(header, STRATEGY);
+		write(fd, header.data(), header.size());
+	}
+
+	// Input read ahead of the parser belongs to the next frame
+	void frame(int turn, const InputReader &reader)
+	{
+		size_t used = input.size() - reader.pending();
+		string frame;
+		writeVarint(frame, turn);
+		writeVarint(frame, used);
+		frame.append(input, 0, used);
+		writeVarint(frame, output.size());
+		frame += output;
+		input.erase(0, used);
+		output.clear();
+		size_t done = 0;
+		while (done < frame.size())
+		{
+			int n = write(fd, frame.data() + done, frame.size() - done);
+			if (n <= 0)
+				break;
+			done += n;
+		}
+	}
+};
+
+class ReplayFrame
+{
+public:
+	int turn;
+	string input;
+	string output;
+};
+
+class ReplayReader
+{
+public:
+	int strategy;
+	vector<ReplayFrame> frames;
+
+	ReplayReader() : strategy(-1) {}
+
+	// False for a file that is not a replay of this format version
+	bool load(const char *path)
+	{
+		int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+		string data;
+		char chunk[INPUT_BUFFER_SIZE];
+		int n;
+		while ((n = read(fd, chunk, sizeof(chunk))) > 0)
+			data.append(chunk, n);
+		close(fd);
+		size_t pos = strlen(REPLAY_MAGIC);
+		uint64_t version, recorded;
+		if (data.compare(0, pos, REPLAY_MAGIC) != 0 || !readVarint(data, pos, version) || version != REPLAY_VERSION || !readVarint(data, pos, recorded))
+			return false;
+		strategy = recorded;
+		frames.clear();
+		while (pos < data.size())
+		{
+			ReplayFrame f;
+			uint64_t turn, inLen, outLen;
+			if (!readVarint(data, pos, turn) || !readVarint(data, pos, inLen) || pos + inLen > data.size())
+				return false;
+			f.turn = turn;
+			f.input = data.substr(pos, inLen);
+			pos += inLen;
+			if (!readVarint(data, pos, outLen) || pos + outLen > data.size())
+				return false;
+			f.output = data.substr(pos, outLen);
+			pos += outLen;
+			frames.push_back(f);
+		}
+		return true;
+	}
+
+	// Every frame's input back to back, as the bot read it
+	string input() const
+	{
+		string all;
+		for (auto &f : frames)
+			all += f.input;
+		return all;
+	}
+};
+
+#endif
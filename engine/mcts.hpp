@@ -0,0 +1,203 @@
+#ifndef ENGINE_MCTS_HPP
+#define ENGINE_MCTS_HPP
+
+#include "plan.hpp"
+#include "timing.hpp"
+
+// Decoupled UCT over my two drones: every node keeps separate statistics for
+// each drone's PlanMoves, each drone picks its own move by UCB and the pair
+// leads to a child. Below the tree, random useful moves are played out to
+// MCTS_DEPTH turns and the final state is scored by PlanEvaluator. Nodes come
+// from a pool allocated once; when it runs out the tree stops growing and
+// iterations keep refining the existing statistics.
+class MctsPlanner
+{
+	class Node
+	{
+	public:
+		int firstChild;
+		int nextSibling;
+		int moves;
+		int visits;
+		int count[2][PLAN_MOVES];
+		float value[2][PLAN_MOVES];
+	};
+
+	class Step
+	{
+	public:
+		int node;
+		int move[2];
+	};
+
+	vector<Node> pool;
+	int used;
+	float minReward;
+	float maxReward;
+	uint32_t rng;
+
+	uint32_t random()
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		return rng;
+	}
+
+	int allocate(int moves)
+	{
+		if (used == (int)pool.size())
+			return -1;
+		Node &n = pool[used];
+		n.firstChild = -1;
+		n.nextSibling = -1;
+		n.moves = moves;
+		n.visits = 0;
+		for (int k = 0; k < 2; k++)
+		{
+			for (int m = 0; m < PLAN_MOVES; m++)
+			{
+				n.count[k][m] = 0;
+				n.value[k][m] = 0;
+			}
+		}
+		return used++;
+	}
+
+	// Untried moves first, from a random offset, then UCB on rewards scaled to [0, 1]
+	int select(const Node &n, int k, const SimDrone &d)
+	{
+		int offset = random() % PLAN_MOVES;
+		int best = -1;
+		double bestScore = 0;
+		double range = maxReward > minReward ? maxReward - minReward : 1;
+		double logVisits = log(n.visits + 1);
+		for (int j = 0; j < PLAN_MOVES; j++)
+		{
+			int m = (j + offset) % PLAN_MOVES;
+			if (!PlanMoves::useful(d, m))
+				continue;
+			if (n.count[k][m] == 0)
+				return m;
+			double mean = (n.value[k][m] / n.count[k][m] - minReward) / range;
+			double score = mean + MCTS_EXPLORATION * sqrt(logVisits / n.count[k][m]);
+			if (best == -1 || score > bestScore)
+			{
+				best = m;
+				bestScore = score;
+			}
+		}
+		return best;
+	}
+
+	int randomMove(const SimDrone &d)
+	{
+		int m = random() % PLAN_MOVES;
+		while (!PlanMoves::useful(d, m))
+			m = random() % PLAN_MOVES;
+		return m;
+	}
+
+	int child(int node, int moves)
+	{
+		for (int c = pool[node].firstChild; c != -1; c = pool[c].nextSibling)
+		{
+			if (pool[c].moves == moves)
+				return c;
+		}
+		int c = allocate(moves);
+		if (c != -1)
+		{
+			pool[c].nextSibling = pool[node].firstChild;
+			pool[node].firstChild = c;
+		}
+		return c;
+	}
+
+public:
+	int iterations;
+
+	MctsPlanner() : pool(MCTS_NODES), used(0), minReward(0), maxReward(0), rng(0x2545f491), iterations(0) {}
+
+	int nodes() const
+	{
+		return used;
+	}
+
+	// Returns false when not even one iteration fit in the budget
+	bool plan(const SimState &root, const SimAction *oppActions, const TurnTimer &timer, SimAction *best)
+	{
+		SimAction actions[SIM_DRONES];
+		actions[2] = oppActions[0];
+		actions[3] = oppActions[1];
+		Step path[MCTS_DEPTH];
+		used = 0;
+		iterations = 0;
+		allocate(-1);
+		bool first = true;
+		while (!((iterations & 15) == 0 && timer.searchExpired()))
+		{
+			SimState s = root;
+			int node = 0;
+			int depth = 0;
+			int length = 0;
+			// Down the tree while the children exist, growing it by one node
+			while (node != -1 && depth < MCTS_DEPTH)
+			{
+				Step &step = path[length++];
+				step.node = node;
+				step.move[0] = select(pool[node], 0, s.drones[0]);
+				step.move[1] = select(pool[node], 1, s.drones[1]);
+				actions[0] = PlanMoves::droneAction(s.drones[0], step.move[0]);
+				actions[1] = PlanMoves::droneAction(s.drones[1], step.move[1]);
+				s.step(actions);
+				depth++;
+				bool expanded = pool[node].visits == 0;
+				node = expanded ? -1 : child(node, step.move[0] + step.move[1] * PLAN_MOVES);
+			}
+			// Rollout: each drone keeps its last heading, light off, and now and then turns
+			int heading[2] = {path[length - 1].move[0] & ~1, path[length - 1].move[1] & ~1};
+			for (; depth < MCTS_DEPTH; depth++)
+			{
+				for (int k = 0; k < 2; k++)
+				{
+					if (random() % 4 == 0)
+						heading[k] = randomMove(s.drones[k]) & ~1;
+					actions[k] = PlanMoves::droneAction(s.drones[k], heading[k]);
+				}
+				s.step(actions);
+			}
+			float reward = PlanEvaluator::evaluate(s);
+			minReward = first ? reward : min(minReward, reward);
+			maxReward = first ? reward : max(maxReward, reward);
+			first = false;
+			for (int i = 0; i < length; i++)
+			{
+				Node &n = pool[path[i].node];
+				n.visits++;
+				for (int k = 0; k < 2; k++)
+				{
+					n.count[k][path[i].move[k]]++;
+					n.value[k][path[i].move[k]] += reward;
+				}
+			}
+			iterations++;
+		}
+		if (iterations == 0)
+			return false;
+		// Most visited move of each drone at the root
+		for (int k = 0; k < 2; k++)
+		{
+			int move = 0;
+			for (int m = 1; m < PLAN_MOVES; m++)
+			{
+				if (pool[0].count[k][m] > pool[0].count[k][move])
+					move = m;
+			}
+			best[k] = PlanMoves::droneAction(root.drones[k], move);
+		}
+		return true;
+	}
+};
+
+#endif
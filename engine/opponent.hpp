@@ -0,0 +1,107 @@
+#ifndef ENGINE_OPPONENT_HPP
+#define ENGINE_OPPONENT_HPP
+
+#include "drone.hpp"
+#include "sim.hpp"
+
+// Where the opponent's drones are going, from their last OPP_HISTORY
+// positions: each keeps its average heading. A drone carrying scans is
+// expected to surface as it rises, or when it reaches OPP_TURN_DEPTH or
+// runs out of battery on the way down. Updated once per turn; queries only
+// read the cached tracks.
+class OpponentPredictor
+{
+	class Track
+	{
+	public:
+		int x[OPP_HISTORY];
+		int y[OPP_HISTORY];
+		int count;
+		int vx;
+		int vy;
+		int surfaceIn;
+		SimAction action;
+	};
+
+	Track tracks[SIM_DRONES / 2];
+	int trackCount;
+
+	// Turns until the drone saves its scans, -1 when it carries none or loses them
+	static int turnsToSave(const Drone &d, const Track &t)
+	{
+		if (d.scans == 0 || d.emergency)
+			return -1;
+		if (t.vy < 0)
+			return turnsToRise(d.y, -t.vy);
+		if (t.vy == 0 || d.battery < LIGHT_COST)
+			return turnsToRise(d.y, DRONE_MOVE);
+		int dive = d.y < OPP_TURN_DEPTH ? (OPP_TURN_DEPTH - d.y + t.vy - 1) / t.vy : 0;
+		return dive + turnsToRise(max(d.y, OPP_TURN_DEPTH), DRONE_MOVE);
+	}
+
+public:
+	OpponentPredictor() : trackCount(0)
+	{
+		for (int k = 0; k < SIM_DRONES / 2; k++)
+			tracks[k].count = 0;
+	}
+
+	static int turnsToRise(int y, int speed)
+	{
+		return y <= SURFACE_Y ? 0 : (y - SURFACE_Y + speed - 1) / speed;
+	}
+
+	// first starts the tracks over, on the first turn of a match
+	void update(const vector<Drone> &drones, bool first)
+	{
+		trackCount = min((int)drones.size(), SIM_DRONES / 2);
+		for (int k = 0; k < trackCount; k++)
+		{
+			const Drone &d = drones[k];
+			Track &t = tracks[k];
+			// An emergency breaks the heading: start over
+			if (first || d.emergency)
+				t.count = 0;
+			if (t.count == OPP_HISTORY)
+			{
+				for (int h = 1; h < OPP_HISTORY; h++)
+				{
+					t.x[h - 1] = t.x[h];
+					t.y[h - 1] = t.y[h];
+				}
+				t.count--;
+			}
+			t.x[t.count] = d.x;
+			t.y[t.count] = d.y;
+			t.count++;
+			int steps = t.count - 1;
+			t.vx = steps ? (t.x[steps] - t.x[0]) / steps : 0;
+			t.vy = steps ? (t.y[steps] - t.y[0]) / steps : 0;
+			t.surfaceIn = turnsToSave(d, t);
+			if (d.emergency || (t.vx == 0 && t.vy == 0))
+				t.action = SimAction();
+			else
+			{
+				// Far along the heading, so the move is the same on every simulated turn
+				int x = min(max(d.x + t.vx * OPP_PREDICT_TURNS, 0), MAP_SIZE - 1);
+				int y = min(max(d.y + t.vy * OPP_PREDICT_TURNS, 0), MAP_SIZE - 1);
+				t.action = SimAction(x, y, d.lit && d.battery >= LIGHT_COST);
+			}
+		}
+	}
+
+	// Fixed actions for the planners; drones not tracked wait
+	void actions(SimAction *out) const
+	{
+		for (int k = 0; k < SIM_DRONES / 2; k++)
+			out[k] = k < trackCount ? tracks[k].action : SimAction();
+	}
+
+	// Turns until drone k saves its scans, -1 when it is not expected to
+	int surfaceIn(int k) const
+	{
+		return k < trackCount ? tracks[k].surfaceIn : -1;
+	}
+};
+
+#endif
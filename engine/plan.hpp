@@ -0,0 +1,92 @@
+#ifndef ENGINE_PLAN_HPP
+#define ENGINE_PLAN_HPP
+
+#include "geometry.hpp"
+#include "sim.hpp"
+
+// Moves the planners choose from, per drone: one of 8 headings at full speed,
+// light off (even) or on (odd)
+class PlanMoves
+{
+public:
+	static SimAction droneAction(const SimDrone &d, int move)
+	{
+		int heading = (move >> 1) * (HEADING_RESOLUTION / 8);
+		int x = min(max(d.x + (int)lround(HEADINGS.x[heading] * DRONE_MOVE), 0), MAP_SIZE - 1);
+		int y = min(max(d.y + (int)lround(HEADINGS.y[heading] * DRONE_MOVE), 0), MAP_SIZE - 1);
+		return SimAction(x, y, move & 1);
+	}
+
+	// Moves that lead to distinct states: an emergency drone ignores its
+	// action, and the light needs battery
+	static bool useful(const SimDrone &d, int move)
+	{
+		if (d.emergency)
+			return move == 0;
+		return !(move & 1) || d.battery >= LIGHT_COST;
+	}
+};
+
+class PlanEvaluator
+{
+public:
+	static int scanValue(const SimState &s, int i)
+	{
+		return (s.type[i] + 1) * (s.savedByOpp & BIT(i) ? 1 : 2);
+	}
+
+	// Score difference, plus what saving the scans carried would earn (worth
+	// more the closer to the surface, less when opponent drones nearer the
+	// surface carry scans that take the first-save bonuses), minus the
+	// distance to fish still to scan and monster threat
+	static double evaluate(const SimState &s)
+	{
+		double score = (s.myScore - s.oppScore) * 100.0;
+		uint64_t carried = 0;
+		for (int k = 0; k < SIM_DRONES / 2; k++)
+		{
+			const SimDrone &d = s.drones[k];
+			if (d.emergency)
+				score -= 500;
+			carried |= d.scans;
+			uint64_t oppPending = 0;
+			for (int j = SIM_DRONES / 2; j < SIM_DRONES; j++)
+			{
+				if (!s.drones[j].emergency && s.drones[j].y < d.y)
+					oppPending |= s.drones[j].scans;
+			}
+			int gain = s.scorer.gain(d.scans, s.savedByMe, s.savedByOpp);
+			int atRisk = s.scorer.race(d.scans, s.savedByMe, s.savedByOpp, oppPending);
+			score += (gain - atRisk * RACE_RISK) * (70.0 - 20.0 * d.y / MAP_SIZE);
+		}
+		for (uint64_t m = s.fish & ~s.lost & ~s.savedByMe & ~carried; m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			int best = MAP_SIZE * 2;
+			for (int k = 0; k < SIM_DRONES / 2; k++)
+			{
+				const SimDrone &d = s.drones[k];
+				if (!d.emergency)
+					best = min(best, abs(d.x - s.x[i]) + abs(d.y - s.y[i]));
+			}
+			score -= scanValue(s, i) * best / 1000.0;
+		}
+		for (int k = 0; k < SIM_DRONES / 2; k++)
+		{
+			const SimDrone &d = s.drones[k];
+			for (uint64_t m = s.monsters & s.grid.near(d.x, d.y, DANGER_RADIUS); m; m &= m - 1)
+			{
+				int i = __builtin_ctzll(m);
+				int dx = s.x[i] - d.x;
+				int dy = s.y[i] - d.y;
+				int dist2 = dx * dx + dy * dy;
+				if (dist2 < DANGER_RADIUS * DANGER_RADIUS)
+					score -= 30.0 * (DANGER_RADIUS * DANGER_RADIUS - dist2) / (DANGER_RADIUS * DANGER_RADIUS);
+			}
+			score += d.battery * 0.5;
+		}
+		return score;
+	}
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef ENGINE_RHEA_HPP
+#define ENGINE_RHEA_HPP
+
+#include "plan.hpp"
+#include "timing.hpp"
+
+// Rolling horizon evolution: a population of RHEA_HORIZON-turn move sequences
+// for both of my drones, scored by simulating them and summing PlanEvaluator
+// after every turn, discounted by RHEA_DISCOUNT. The population survives
+// between turns: every genome is shifted by the turn just played and gets a
+// random move at its end, so the search resumes from last turn's best plans.
+// Steady state: each child, from two tournament-selected parents by uniform
+// crossover and mutation, replaces the worst genome when it scores better.
+class EvolutionPlanner
+{
+	class Genome
+	{
+	public:
+		unsigned char moves[RHEA_HORIZON][2];
+		double score;
+	};
+
+	Genome population[RHEA_POPULATION];
+	bool started;
+	uint32_t rng;
+
+	uint32_t random()
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		return rng;
+	}
+
+	void randomize(Genome &g, int from)
+	{
+		for (int t = from; t < RHEA_HORIZON; t++)
+		{
+			g.moves[t][0] = random() % PLAN_MOVES;
+			g.moves[t][1] = random() % PLAN_MOVES;
+		}
+	}
+
+	double evaluate(const SimState &root, const SimAction *oppActions, const Genome &g)
+	{
+		SimState s = root;
+		SimAction actions[SIM_DRONES];
+		actions[2] = oppActions[0];
+		actions[3] = oppActions[1];
+		double score = 0;
+		double weight = 1;
+		for (int t = 0; t < RHEA_HORIZON; t++)
+		{
+			actions[0] = PlanMoves::droneAction(s.drones[0], g.moves[t][0]);
+			actions[1] = PlanMoves::droneAction(s.drones[1], g.moves[t][1]);
+			s.step(actions);
+			score += weight * PlanEvaluator::evaluate(s);
+			weight *= RHEA_DISCOUNT;
+		}
+		evaluations++;
+		return score;
+	}
+
+	int tournament()
+	{
+		int a = random() % RHEA_POPULATION;
+		int b = random() % RHEA_POPULATION;
+		return population[a].score >= population[b].score ? a : b;
+	}
+
+public:
+	int evaluations;
+	int generations;
+
+	EvolutionPlanner() : started(false), rng(0x6c8e9cf5), evaluations(0), generations(0) {}
+
+	// Returns false when the budget ran out before the population was scored
+	bool plan(const SimState &root, const SimAction *oppActions, const TurnTimer &timer, SimAction *best)
+	{
+		evaluations = 0;
+		generations = 0;
+		for (int i = 0; i < RHEA_POPULATION; i++)
+		{
+			Genome &g = population[i];
+			if (!started)
+			{
+				// Straight lines along each heading pair as a start, the rest random
+				for (int t = 0; t < RHEA_HORIZON; t++)
+				{
+					g.moves[t][0] = (i * 2) % PLAN_MOVES;
+					g.moves[t][1] = (i * 2 + 8) % PLAN_MOVES;
+				}
+				if (i >= PLAN_MOVES / 2)
+					randomize(g, 0);
+				continue;
+			}
+			for (int t = 0; t + 1 < RHEA_HORIZON; t++)
+			{
+				g.moves[t][0] = g.moves[t + 1][0];
+				g.moves[t][1] = g.moves[t + 1][1];
+			}
+			randomize(g, RHEA_HORIZON - 1);
+		}
+		started = true;
+		for (int i = 0; i < RHEA_POPULATION; i++)
+		{
+			if (timer.searchExpired())
+				return false;
+			population[i].score = evaluate(root, oppActions, population[i]);
+		}
+
+		while (!timer.searchExpired())
+		{
+			Genome child;
+			const Genome &a = population[tournament()];
+			const Genome &b = population[tournament()];
+			for (int t = 0; t < RHEA_HORIZON; t++)
+			{
+				for (int k = 0; k < 2; k++)
+					child.moves[t][k] = random() & 1 ? a.moves[t][k] : b.moves[t][k];
+			}
+			int mutations = 1 + random() % 2;
+			for (int m = 0; m < mutations; m++)
+				child.moves[random() % RHEA_HORIZON][random() % 2] = random() % PLAN_MOVES;
+			child.score = evaluate(root, oppActions, child);
+			int worst = 0;
+			for (int i = 1; i < RHEA_POPULATION; i++)
+			{
+				if (population[i].score < population[worst].score)
+					worst = i;
+			}
+			if (child.score > population[worst].score)
+				population[worst] = child;
+			generations++;
+		}
+
+		int bestIndex = 0;
+		for (int i = 1; i < RHEA_POPULATION; i++)
+		{
+			if (population[i].score > population[bestIndex].score)
+				bestIndex = i;
+		}
+		best[0] = PlanMoves::droneAction(root.drones[0], population[bestIndex].moves[0][0]);
+		best[1] = PlanMoves::droneAction(root.drones[1], population[bestIndex].moves[0][1]);
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef ENGINE_RULES_HPP
+#define ENGINE_RULES_HPP
+
+#include "game.hpp"
+
+// Moves shared by the rule based variants. protectionMode searches the 360
+// headings of a full move for the one closest to the planned target that
+// keeps out of EMERGENCY_RADIUS of every monster along the way, monsters
+// moving on at their last seen speed. cake surfaces to save the scans,
+// dodging the monsters in sight above the drone. Variants override either.
+class RuleStrategy : public GameState
+{
+public:
+	virtual void protectionMode(Drone &d)
+	{
+		pair<int, int> originalTarget = d.getTarget();
+		int originalTargetX = originalTarget.first;
+		int originalTargetY = originalTarget.second;
+		pair<double, double> originalVector = make_pair(originalTargetX - d.x, originalTargetY - d.y);
+		double norm = sqrt(originalVector.first * originalVector.first + originalVector.second * originalVector.second);
+		originalVector.first /= norm;
+		originalVector.second /= norm;
+
+		vector<Creature *> danger;
+		for (auto &m : monsters)
+		{
+			if (!m->isVisible())
+				continue;
+			if (d.distanceTo(m) > DANGER_RADIUS)
+				continue;
+			danger.push_back(m);
+		}
+		if (danger.size() == 0)
+			return;
+
+		int minDistance = 1000000;
+		pair<int, int> bestPosition = make_pair(-1, -1);
+		for (int i = 0; i < 360; i++)
+		{
+			double angle = i * M_PI / 180;
+			pair<double, double> rotatedVector = make_pair(originalVector.first * cos(angle) - originalVector.second * sin(angle), originalVector.first * sin(angle) + originalVector.second * cos(angle));
+			pair<int, int> targetVector = make_pair(rotatedVector.first * 600, rotatedVector.second * 600);
+			vector<double> split = {0.05, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 0.95, 1};
+			bool danger = false;
+			for (double s : split)
+			{
+				pair<int, int> partialTarget = make_pair(d.x + targetVector.first * s, d.y + targetVector.second * s);
+				for (auto &m : monsters)
+				{
+					pair<int, int> partialMonster = make_pair(m->x + m->dx * s, m->y + m->dy * s);
+					int dist = sqrt((partialTarget.first - partialMonster.first) * (partialTarget.first - partialMonster.first) + (partialTarget.second - partialMonster.second) * (partialTarget.second - partialMonster.second));
+					if (dist < EMERGENCY_RADIUS + 10)
+					{
+						danger = true;
+						break;
+					}
+				}
+			}
+			if (danger)
+				continue;
+			int distance = sqrt((d.x + targetVector.first - originalTargetX) * (d.x + targetVector.first - originalTargetX) + (d.y + targetVector.second - originalTargetY) * (d.y + targetVector.second - originalTargetY));
+			if (distance < minDistance)
+			{
+				minDistance = distance;
+				bestPosition = make_pair(d.x + targetVector.first, d.y + targetVector.second);
+			}
+		}
+		if (bestPosition.first != -1 && bestPosition.second != -1)
+		{
+			d.move(bestPosition.first, bestPosition.second, "Ahhh");
+		}
+		else
+		{
+			d.move(originalTargetX, originalTargetY, "My time has come");
+		}
+	}
+
+	virtual void cake(Drone &d)
+	{
+		if (areAllFishScanned())
+			d.setBigLight();
+		vector<Creature *> danger;
+		for (auto &m : monsters)
+		{
+			if (!m->isVisible())
+				continue;
+			if (d.distanceTo(m) > DANGER_RADIUS)
+				continue;
+			if (m->y > d.y)
+				continue;
+			danger.push_back(m);
+		}
+		d.move(d.x, SCAN_SAVE, "The cake is a lie");
+		if (danger.size() > 0)
+			protectionMode(d);
+	}
+};
+
+#endif
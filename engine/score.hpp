@@ -0,0 +1,60 @@
+#ifndef ENGINE_SCORE_HPP
+#define ENGINE_SCORE_HPP
+
+#include "creatures.hpp"
+
+// Exact points of a surface save: each fish is worth its type + 1, a color
+// (all types of it) COLOR_COMBO_POINTS and a type (all colors of it)
+// TYPE_COMBO_POINTS, each doubled for whoever saves it first. Both players
+// saving on the same turn both count as first. Fish are counted per type
+// mask, so the cost of a query does not depend on how many fish are saved.
+class SaveScorer
+{
+public:
+	uint64_t colors[FISH_COLORS];
+	uint64_t types[FISH_TYPES];
+
+	void setup(const CreatureStore &store, uint64_t indexes)
+	{
+		for (int c = 0; c < FISH_COLORS; c++)
+			colors[c] = 0;
+		for (int t = 0; t < FISH_TYPES; t++)
+			types[t] = store.fish(t) & indexes;
+		for (uint64_t m = store.fish() & indexes; m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			colors[store.color[i]] |= BIT(i);
+		}
+	}
+
+	// Points for saving the fish in saves, given what each player had saved before
+	int gain(uint64_t saves, uint64_t mine, uint64_t theirs) const
+	{
+		saves &= ~mine;
+		if (saves == 0)
+			return 0;
+		uint64_t after = mine | saves;
+		int points = 0;
+		for (int t = 0; t < FISH_TYPES; t++)
+		{
+			uint64_t s = saves & types[t];
+			points += (t + 1) * (__builtin_popcountll(s) + __builtin_popcountll(s & ~theirs));
+			if ((after & types[t]) == types[t] && (mine & types[t]) != types[t])
+				points += TYPE_COMBO_POINTS * ((theirs & types[t]) == types[t] ? 1 : 2);
+		}
+		for (int c = 0; c < FISH_COLORS; c++)
+		{
+			if ((after & colors[c]) == colors[c] && (mine & colors[c]) != colors[c])
+				points += COLOR_COMBO_POINTS * ((theirs & colors[c]) == colors[c] ? 1 : 2);
+		}
+		return points;
+	}
+
+	// Points my saves lose if the opponent saves its pending scans first
+	int race(uint64_t saves, uint64_t mine, uint64_t theirs, uint64_t theirPending) const
+	{
+		return gain(saves, mine, theirs) - gain(saves, mine, theirs | theirPending);
+	}
+};
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef ENGINE_SIM_HPP
+#define ENGINE_SIM_HPP
+
+#include "score.hpp"
+#include "grid.hpp"
+
+// What a drone does for one simulated turn: MOVE toward (x, y), or WAIT when move is false
+class SimAction
+{
+public:
+	int x;
+	int y;
+	bool move;
+	bool light;
+
+	SimAction() : x(0), y(0), move(false), light(false) {}
+	SimAction(int x, int y, bool light) : x(x), y(y), move(true), light(light) {}
+};
+
+class SimDrone
+{
+public:
+	int x;
+	int y;
+	int battery;
+	bool emergency;
+	bool light;
+	uint64_t scans;
+};
+
+// Compact, copyable game state for planning: creatures the bot knows the
+// position of, all four drones (mine first, then the opponent's), saved sets
+// and scores, combos included (SaveScorer). step() advances it one turn with
+// the referee's rules, simplified where the exact rule needs information the
+// bot does not have.
+class SimState
+{
+public:
+	int turn;
+	int creatureCount;
+	int x[SIM_MAX_CREATURES];
+	int y[SIM_MAX_CREATURES];
+	int vx[SIM_MAX_CREATURES];
+	int vy[SIM_MAX_CREATURES];
+	int type[SIM_MAX_CREATURES];
+	// Creature masks, same indexes as the arrays above
+	uint64_t fish;
+	uint64_t monsters;
+	uint64_t lost;
+	uint64_t savedByMe;
+	uint64_t savedByOpp;
+	int myScore;
+	int oppScore;
+	SaveScorer scorer;
+	// Where the creatures not lost are, kept up to date by step()
+	SpatialGrid grid;
+	SimDrone drones[SIM_DRONES];
+
+	// Builds the grid once the creatures are placed
+	void index()
+	{
+		grid.clear();
+		for (uint64_t m = ~lost & (BIT(creatureCount) - 1); m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			grid.insert(i, x[i], y[i]);
+		}
+	}
+
+	static int habitatTop(int type)
+	{
+		return type < 0 ? TOP_LIMIT : TOP_LIMIT + type * (MID_LIMIT - TOP_LIMIT);
+	}
+
+	static int habitatBottom(int type)
+	{
+		return type < 0 || type == 2 ? MAP_SIZE - 1 : MID_LIMIT + type * (MID_LIMIT - TOP_LIMIT);
+	}
+
+	static void setSpeed(int &vx, int &vy, int dx, int dy, int speed)
+	{
+		int norm2 = dx * dx + dy * dy;
+		if (norm2 == 0)
+			return;
+		float scale = speed / sqrtf((float)norm2);
+		vx = (int)(dx * scale);
+		vy = (int)(dy * scale);
+	}
+
+	void moveDrones(const SimAction *actions, int *startX, int *startY)
+	{
+		for (int k = 0; k < SIM_DRONES; k++)
+		{
+			SimDrone &d = drones[k];
+			const SimAction &a = actions[k];
+			startX[k] = d.x;
+			startY[k] = d.y;
+			d.light = a.light && !d.emergency && d.battery >= LIGHT_COST;
+			d.battery = d.light ? d.battery - LIGHT_COST : min(DRONE_MAX_BATTERY, d.battery + 1);
+			if (d.emergency)
+				d.y -= DRONE_EMERGENCY_RISE;
+			else if (!a.move)
+				d.y += DRONE_SINK;
+			else
+			{
+				int dx = a.x - d.x;
+				int dy = a.y - d.y;
+				int dist2 = dx * dx + dy * dy;
+				if (dist2 <= DRONE_MOVE * DRONE_MOVE)
+				{
+					d.x = a.x;
+					d.y = a.y;
+				}
+				else
+				{
+					float scale = DRONE_MOVE / sqrtf((float)dist2);
+					d.x += (int)(dx * scale);
+					d.y += (int)(dy * scale);
+				}
+			}
+			d.x = min(max(d.x, 0), MAP_SIZE - 1);
+			d.y = min(max(d.y, 0), MAP_SIZE - 1);
+		}
+	}
+
+	// Same closest approach test as EvasionKernel, at the real contact radius.
+	// Monsters have not moved yet: only those within a drone move, a monster
+	// move and the contact radius of the drone's start can reach it
+	void collide(const int *startX, const int *startY)
+	{
+		for (int k = 0; k < SIM_DRONES; k++)
+		{
+			SimDrone &d = drones[k];
+			if (d.emergency)
+				continue;
+			uint64_t reach = grid.near(startX[k], startY[k], DRONE_MOVE + MONSTER_ATTACK_SPEED + EMERGENCY_RADIUS);
+			for (uint64_t m = monsters & reach; m; m &= m - 1)
+			{
+				int i = __builtin_ctzll(m);
+				double rx = startX[k] - x[i];
+				double ry = startY[k] - y[i];
+				double ux = d.x - startX[k] - vx[i];
+				double uy = d.y - startY[k] - vy[i];
+				double uu = ux * ux + uy * uy;
+				double t = uu > 0 ? min(1.0, max(0.0, -(rx * ux + ry * uy) / uu)) : 0;
+				double dx = rx + ux * t;
+				double dy = ry + uy * t;
+				if (dx * dx + dy * dy <= EMERGENCY_RADIUS * EMERGENCY_RADIUS)
+				{
+					d.emergency = true;
+					d.light = false;
+					d.scans = 0;
+					break;
+				}
+			}
+		}
+	}
+
+	void moveCreatures()
+	{
+		for (int i = 0; i < creatureCount; i++)
+		{
+			if (lost & BIT(i))
+				continue;
+			int fromX = x[i];
+			int fromY = y[i];
+			x[i] += vx[i];
+			y[i] += vy[i];
+			if (x[i] < 0 || x[i] >= MAP_SIZE)
+			{
+				x[i] = min(max(x[i], 0), MAP_SIZE - 1);
+				if (fish & BIT(i))
+				{
+					lost |= BIT(i);
+					grid.remove(i, fromX, fromY);
+					continue;
+				}
+			}
+			y[i] = min(max(y[i], habitatTop(type[i])), habitatBottom(type[i]));
+			grid.move(i, fromX, fromY, x[i], y[i]);
+		}
+	}
+
+	void scanAndSave()
+	{
+		uint64_t reachable = fish & ~lost;
+		for (int k = 0; k < SIM_DRONES; k++)
+		{
+			SimDrone &d = drones[k];
+			if (d.emergency)
+			{
+				if (d.y <= SURFACE_Y)
+					d.emergency = false;
+				continue;
+			}
+			int radius = d.light ? BIG_LIGHT_RADIUS : LOW_LIGHT_RADIUS;
+			for (uint64_t m = reachable & ~d.scans & grid.near(d.x, d.y, radius); m; m &= m - 1)
+			{
+				int i = __builtin_ctzll(m);
+				int dx = x[i] - d.x;
+				int dy = y[i] - d.y;
+				if (dx * dx + dy * dy <= radius * radius)
+					d.scans |= BIT(i);
+			}
+		}
+		uint64_t mySaves = 0;
+		uint64_t oppSaves = 0;
+		for (int k = 0; k < SIM_DRONES; k++)
+		{
+			SimDrone &d = drones[k];
+			if (d.emergency || d.y > SURFACE_Y)
+				continue;
+			if (k < SIM_DRONES / 2)
+				mySaves |= d.scans;
+			else
+				oppSaves |= d.scans;
+			d.scans = 0;
+		}
+		myScore += scorer.gain(mySaves, savedByMe, savedByOpp);
+		oppScore += scorer.gain(oppSaves, savedByOpp, savedByMe);
+		savedByMe |= mySaves;
+		savedByOpp |= oppSaves;
+	}
+
+	// Fish flee drones they hear, monsters chase the closest drone whose light reaches them
+	void updateSpeeds()
+	{
+		int fishRange2[SIM_DRONES];
+		int monsterRange2[SIM_DRONES];
+		// Creatures each drone may reach, fish or monsters, from the grid
+		uint64_t near[SIM_DRONES];
+		for (int k = 0; k < SIM_DRONES; k++)
+		{
+			int light = drones[k].light ? BIG_LIGHT_RADIUS : LOW_LIGHT_RADIUS;
+			fishRange2[k] = drones[k].emergency ? -1 : FISH_HEARING_RADIUS * FISH_HEARING_RADIUS;
+			monsterRange2[k] = drones[k].emergency ? -1 : light * light;
+			near[k] = drones[k].emergency ? 0 : grid.near(drones[k].x, drones[k].y, max(FISH_HEARING_RADIUS, light));
+		}
+		for (uint64_t m = ~lost & (BIT(creatureCount) - 1); m; m &= m - 1)
+		{
+			int i = __builtin_ctzll(m);
+			bool isFish = type[i] >= 0;
+			const int *range2 = isFish ? fishRange2 : monsterRange2;
+			int best = -1;
+			int bestDist2 = 0;
+			for (int k = 0; k < SIM_DRONES; k++)
+			{
+				if (!(near[k] & BIT(i)))
+					continue;
+				int dx = drones[k].x - x[i];
+				int dy = drones[k].y - y[i];
+				int dist2 = dx * dx + dy * dy;
+				if (dist2 <= range2[k] && (best == -1 || dist2 < bestDist2))
+				{
+					best = k;
+					bestDist2 = dist2;
+				}
+			}
+			if (best != -1 && isFish)
+				setSpeed(vx[i], vy[i], x[i] - drones[best].x, y[i] - drones[best].y, FISH_FLEE_SPEED);
+			else if (best != -1)
+				setSpeed(vx[i], vy[i], drones[best].x - x[i], drones[best].y - y[i], MONSTER_ATTACK_SPEED);
+			else
+			{
+				int cruise = isFish ? FISH_SPEED : MONSTER_SPEED;
+				if (vx[i] * vx[i] + vy[i] * vy[i] > cruise * cruise)
+					setSpeed(vx[i], vy[i], vx[i], vy[i], cruise);
+			}
+			if (y[i] + vy[i] < habitatTop(type[i]) || y[i] + vy[i] > habitatBottom(type[i]))
+				vy[i] = -vy[i];
+		}
+	}
+
+	void step(const SimAction *actions)
+	{
+		int startX[SIM_DRONES];
+		int startY[SIM_DRONES];
+		moveDrones(actions, startX, startY);
+		collide(startX, startY);
+		moveCreatures();
+		scanAndSave();
+		updateSpeeds();
+		turn++;
+	}
+};
+
+#endif
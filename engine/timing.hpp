@@ -0,0 +1,186 @@
+#ifndef ENGINE_TIMING_HPP
+#define ENGINE_TIMING_HPP
+
+#include "config.hpp"
+
+#ifdef PROFILE
+// Time spent per phase and per turn, in clock ticks. Phases nest: protection
+// is also counted in decide. The records not written yet go to stderr every
+// PROFILE_DUMP_TURNS turns, and with the summary on LAST_TURN or at exit:
+// the arena and the referee kill the bot without waiting for it to exit.
+enum ProfileSection
+{
+	PROFILE_PARSE,
+	PROFILE_MODELS,
+	PROFILE_DECIDE,
+	PROFILE_PROTECTION,
+	PROFILE_OUTPUT,
+	PROFILE_SECTIONS
+};
+
+class Profiler
+{
+	uint64_t ticks[PROFILE_TURNS][PROFILE_SECTIONS];
+	int calls[PROFILE_TURNS][PROFILE_SECTIONS];
+	int turns[PROFILE_TURNS];
+	int current;
+	int recorded;
+	int dumped;
+	bool finished;
+	double total[PROFILE_SECTIONS];
+	double worst[PROFILE_SECTIONS];
+	int count;
+	uint64_t startTicks;
+	chrono::steady_clock::time_point startTime;
+
+	static void dumpAtExit();
+
+public:
+	static uint64_t now()
+	{
+#ifdef __x86_64__
+		return __rdtsc();
+#else
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	Profiler() : current(0), recorded(0), dumped(0), finished(false), total(), worst(), count(0), startTicks(now()), startTime(chrono::steady_clock::now())
+	{
+		atexit(dumpAtExit);
+	}
+
+	void beginTurn(int turn)
+	{
+		current = recorded++ % PROFILE_TURNS;
+		turns[current] = turn;
+		for (int s = 0; s < PROFILE_SECTIONS; s++)
+		{
+			ticks[current][s] = 0;
+			calls[current][s] = 0;
+		}
+	}
+
+	void add(ProfileSection section, uint64_t elapsed)
+	{
+		ticks[current][section] += elapsed;
+		calls[current][section]++;
+	}
+
+	// Called after each turn's output
+	void endTurn(int turn)
+	{
+		if (turn == LAST_TURN)
+			dump(true);
+		else if (turn % PROFILE_DUMP_TURNS == 0)
+			dump(false);
+	}
+
+	// Ticks are converted with the rate measured since the start of the game
+	void dump(bool summary)
+	{
+		static const char *names[PROFILE_SECTIONS] = {"parse", "models", "decide", "protection", "output"};
+		if (finished)
+			return;
+		finished = summary;
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+		double usPerTick = seconds > 0 ? seconds * 1e6 / (now() - startTicks) : 0;
+		int first = max(dumped, recorded - PROFILE_TURNS);
+		for (int r = first; r < recorded; r++)
+		{
+			int k = r % PROFILE_TURNS;
+			// The input ended during this turn's parse
+			if (calls[k][PROFILE_PARSE] == 0)
+				continue;
+			count++;
+			fprintf(stderr, "turn %3d", turns[k]);
+			for (int s = 0; s < PROFILE_SECTIONS; s++)
+			{
+				double us = ticks[k][s] * usPerTick;
+				total[s] += us;
+				worst[s] = max(worst[s], us);
+				fprintf(stderr, "  %s %.1fus/%d", names[s], us, calls[k][s]);
+			}
+			fprintf(stderr, "\n");
+		}
+		dumped = recorded;
+		for (int s = 0; s < PROFILE_SECTIONS && summary && count > 0; s++)
+			fprintf(stderr, "%-10s mean %8.1fus  max %8.1fus\n", names[s], total[s] / count, worst[s]);
+	}
+};
+
+inline Profiler PROFILER;
+
+inline void Profiler::dumpAtExit()
+{
+	PROFILER.dump(true);
+}
+
+class ScopedTimer
+{
+	ProfileSection section;
+	uint64_t start;
+
+public:
+	ScopedTimer(ProfileSection section) : section(section), start(Profiler::now()) {}
+	~ScopedTimer() { PROFILER.add(section, Profiler::now() - start); }
+};
+
+#define PROFILE_TURN(turn) PROFILER.beginTurn(turn)
+#define PROFILE_END_TURN(turn) PROFILER.endTurn(turn)
+#define PROFILE_SCOPE(section) ScopedTimer profileScope(section)
+#else
+#define PROFILE_TURN(turn)
+#define PROFILE_END_TURN(turn)
+#define PROFILE_SCOPE(section)
+#endif
+
+// Monotonic wall clock budget of one turn. Anything that loops checks expired()
+// and answers with the best result it has so far. Searches check
+// searchExpired(), EVASION_RESERVE_MS earlier, so the evasion after them fits.
+class TurnTimer
+{
+	chrono::steady_clock::time_point startTime;
+	chrono::steady_clock::time_point deadline;
+	chrono::steady_clock::time_point searchDeadline;
+	int budgetMs;
+
+public:
+	TurnTimer() : startTime(chrono::steady_clock::now()), deadline(startTime), searchDeadline(startTime), budgetMs(0) {}
+
+	void start(int budgetMs, int marginMs)
+	{
+		this->budgetMs = budgetMs;
+		startTime = chrono::steady_clock::now();
+		deadline = startTime + chrono::milliseconds(budgetMs - marginMs);
+		searchDeadline = deadline - chrono::milliseconds(EVASION_RESERVE_MS);
+	}
+
+	bool expired() const
+	{
+		return chrono::steady_clock::now() >= deadline;
+	}
+
+	bool searchExpired() const
+	{
+		return chrono::steady_clock::now() >= searchDeadline;
+	}
+
+	double elapsedMs() const
+	{
+		return chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+	}
+
+	double remainingMs() const
+	{
+		return budgetMs - elapsedMs();
+	}
+
+	void report(int turn) const
+	{
+		double used = elapsedMs();
+		cerr << "Turn " << turn << ": " << used << " ms used, " << budgetMs - used << " ms left" << endl;
+	}
+};
+
+#endif
@@ -0,0 +1,109 @@
+// Builds the single file the arena accepts: every #include "..." of the entry
+// file is inlined recursively, each file once; system includes are kept.
+// -D NAME[=VALUE] puts a #define in front, to pick a strategy at bundle time.
+// g++ -O2 -std=c++17 -o bundle tools/bundle.cpp
+// ./bundle [-D NAME[=VALUE]]... <entry.cpp> <output.cpp>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <limits.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// Largest source the arena accepts, in characters
+#define SUBMISSION_LIMIT 100000
+
+static string directoryOf(const string &path)
+{
+	size_t slash = path.rfind('/');
+	return slash == string::npos ? "." : path.substr(0, slash);
+}
+
+static bool expand(const string &path, set<string> &seen, string &out)
+{
+	char resolved[PATH_MAX];
+	if (realpath(path.c_str(), resolved) == nullptr)
+	{
+		cerr << "cannot find " << path << endl;
+		return false;
+	}
+	if (!seen.insert(resolved).second)
+		return true;
+	ifstream in(resolved);
+	if (!in)
+	{
+		cerr << "cannot read " << path << endl;
+		return false;
+	}
+	string line;
+	while (getline(in, line))
+	{
+		size_t start = line.find_first_not_of(" \t");
+		if (start != string::npos && line.compare(start, 10, "#include \"") == 0)
+		{
+			size_t end = line.find('"', start + 10);
+			if (end == string::npos)
+			{
+				cerr << path << ": bad include: " << line << endl;
+				return false;
+			}
+			string name = line.substr(start + 10, end - start - 10);
+			if (!expand(directoryOf(resolved) + "/" + name, seen, out))
+				return false;
+			continue;
+		}
+		out += line;
+		out += '\n';
+	}
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	vector<string> defines;
+	vector<string> files;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "-D" && i + 1 < argc)
+			defines.push_back(argv[++i]);
+		else if (arg.compare(0, 2, "-D") == 0 && arg.size() > 2)
+			defines.push_back(arg.substr(2));
+		else
+			files.push_back(arg);
+	}
+	if (files.size() != 2)
+	{
+		cerr << "usage: " << argv[0] << " [-D NAME[=VALUE]]... <entry.cpp> <output.cpp>" << endl;
+		return 2;
+	}
+
+	string out = "// Generated from " + files[0] + " by tools/bundle.cpp, do not edit\n";
+	for (auto &d : defines)
+	{
+		size_t eq = d.find('=');
+		out += "#define " + (eq == string::npos ? d : d.substr(0, eq) + " " + d.substr(eq + 1)) + "\n";
+	}
+	set<string> seen;
+	if (!expand(files[0], seen, out))
+		return 1;
+
+	ofstream file(files[1]);
+	file << out;
+	if (!file)
+	{
+		cerr << "cannot write " << files[1] << endl;
+		return 1;
+	}
+	cout << files[1] << ": " << seen.size() << " files, " << out.size() << " characters" << endl;
+	if (out.size() > SUBMISSION_LIMIT)
+	{
+		cerr << "over the " << SUBMISSION_LIMIT << " character limit" << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,43 @@
+// Plays one seeded match between two bot binaries.
+// g++ -O2 -std=c++17 -o referee tools/referee.cpp
+// ./referee [--seed N] [--timeout MS] [--stderr] [--verbose] <bot0> <bot1>
+
+#include "referee.hpp"
+
+int main(int argc, char **argv)
+{
+	MatchConfig config;
+	int botCount = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--seed" && i + 1 < argc)
+			config.seed = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--timeout" && i + 1 < argc)
+			config.turnTimeout = atoi(argv[++i]);
+		else if (arg == "--stderr")
+			config.keepStderr = true;
+		else if (arg == "--verbose")
+			config.verbose = true;
+		else if (botCount < 2)
+			config.bots[botCount++] = arg;
+		else
+			botCount = 3;
+	}
+	if (botCount != 2)
+	{
+		cerr << "usage: " << argv[0] << " [--seed N] [--timeout MS] [--stderr] [--verbose] <bot0> <bot1>" << endl;
+		return 2;
+	}
+
+	MatchResult result = runMatch(config);
+	cout << "seed " << config.seed << ": " << result.scores[0] << " - " << result.scores[1] << " after " << result.turns << " turns";
+	for (int p = 0; p < 2; p++)
+	{
+		if (result.timedOut[p])
+			cout << ", player " << p << " timed out";
+	}
+	int winner = result.winner();
+	cout << (winner < 0 ? ", draw" : winner == 0 ? ", player 0 wins" : ", player 1 wins") << endl;
+	return 0;
+}
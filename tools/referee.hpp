@@ -0,0 +1,875 @@
+#ifndef REFEREE_HPP
+#define REFEREE_HPP
+
+// Offline referee for the Fall Challenge 2023 (Seabed Security) rules.
+// Maps are generated from a seed and everything the referee decides is a
+// pure function of that seed and of the bots' commands.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+
+using namespace std;
+
+#define MAP_SIZE 10000
+#define MAX_TURNS 200
+#define DRONES_PER_PLAYER 2
+#define DRONE_START_Y 500
+#define DRONE_MOVE_SPEED 600
+#define DRONE_SINK_SPEED 300
+#define DRONE_EMERGENCY_SPEED 300
+#define DRONE_MAX_BATTERY 30
+#define LIGHT_BATTERY_COST 5
+#define DRONE_BATTERY_REGEN 1
+#define DARK_SCAN_RANGE 800
+#define LIGHT_SCAN_RANGE 2000
+#define DRONE_HIT_RANGE 200
+#define MONSTER_ATTACK_RANGE 300
+#define MONSTER_DETECTED_RANGE_BONUS 300
+#define SURFACE_Y 500
+#define FISH_SWIM_SPEED 200
+#define FISH_FLEE_SPEED 400
+#define FISH_AVOID_RANGE 600
+#define FISH_HEARING_RANGE ((DARK_SCAN_RANGE + LIGHT_SCAN_RANGE) / 2)
+#define MONSTER_SPEED 270
+#define MONSTER_ATTACK_SPEED 540
+#define MONSTER_AVOID_RANGE 600
+#define FISH_COLORS 4
+#define FISH_TYPES 3
+#define COLOR_COMBO_POINTS 3
+#define TYPE_COMBO_POINTS 4
+#define FIRST_TURN_TIMEOUT 1000
+#define TURN_TIMEOUT 50
+
+static const int HABITAT_TOP[FISH_TYPES + 1] = {2500, 2500, 5000, 7500};
+static const int HABITAT_BOTTOM[FISH_TYPES + 1] = {MAP_SIZE - 1, 5000, 7500, MAP_SIZE - 1};
+
+// splitmix64: same sequence on every platform, unlike <random> distributions
+class RefereeRandom
+{
+	uint64_t state;
+
+public:
+	RefereeRandom(uint64_t seed) : state(seed) {}
+
+	uint64_t next()
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	// Uniform in [low, high]
+	int nextInt(int low, int high)
+	{
+		return low + (int)(next() % (uint64_t)(high - low + 1));
+	}
+
+	double nextAngle()
+	{
+		return (next() >> 11) * (1.0 / 9007199254740992.0) * 2 * M_PI;
+	}
+};
+
+class RefCreature
+{
+public:
+	int id;
+	int color;
+	int type;
+	int x;
+	int y;
+	int vx;
+	int vy;
+	bool fleeing;
+	bool lost;
+
+	RefCreature(int id, int color, int type, int x, int y, int vx, int vy) : id(id), color(color), type(type), x(x), y(y), vx(vx), vy(vy), fleeing(false), lost(false) {}
+
+	bool isMonster() const
+	{
+		return type < 0;
+	}
+};
+
+class RefDrone
+{
+public:
+	int id;
+	int owner;
+	int x;
+	int y;
+	int battery;
+	bool emergency;
+	bool lightOn;
+	bool moving;
+	int targetX;
+	int targetY;
+	uint64_t scans;
+
+	RefDrone(int id, int owner, int x, int y) : id(id), owner(owner), x(x), y(y), battery(DRONE_MAX_BATTERY), emergency(false), lightOn(false), moving(false), targetX(x), targetY(y), scans(0) {}
+
+	int lightRadius() const
+	{
+		return lightOn ? LIGHT_SCAN_RANGE : DARK_SCAN_RANGE;
+	}
+};
+
+static long long squaredDistance(int ax, int ay, int bx, int by)
+{
+	long long dx = ax - bx;
+	long long dy = ay - by;
+	return dx * dx + dy * dy;
+}
+
+// Child process speaking the game protocol over its stdin/stdout
+class BotProcess
+{
+	pid_t pid;
+	int toBot;
+	int fromBot;
+	string pending;
+
+public:
+	BotProcess() : pid(-1), toBot(-1), fromBot(-1) {}
+	BotProcess(const BotProcess &) = delete;
+	BotProcess &operator=(const BotProcess &) = delete;
+	~BotProcess() { stop(); }
+
+	bool start(const string &path, bool keepStderr)
+	{
+		int in[2];
+		int out[2];
+		if (pipe2(in, O_CLOEXEC) != 0)
+			return false;
+		if (pipe2(out, O_CLOEXEC) != 0)
+		{
+			close(in[0]);
+			close(in[1]);
+			return false;
+		}
+		pid = fork();
+		if (pid == 0)
+		{
+			dup2(in[0], 0);
+			dup2(out[1], 1);
+			if (!keepStderr)
+			{
+				int devNull = open("/dev/null", O_WRONLY);
+				dup2(devNull, 2);
+			}
+			execl(path.c_str(), path.c_str(), (char *)nullptr);
+			_exit(127);
+		}
+		close(in[0]);
+		close(out[1]);
+		toBot = in[1];
+		fromBot = out[0];
+		return pid > 0;
+	}
+
+	bool send(const string &data)
+	{
+		size_t done = 0;
+		while (done < data.size())
+		{
+			ssize_t n = write(toBot, data.data() + done, data.size() - done);
+			if (n <= 0)
+				return false;
+			done += n;
+		}
+		return true;
+	}
+
+	int output() const
+	{
+		return fromBot;
+	}
+
+	// A complete line already received, if any
+	bool nextLine(string &line)
+	{
+		size_t end = pending.find('\n');
+		if (end == string::npos)
+			return false;
+		line = pending.substr(0, end);
+		pending.erase(0, end + 1);
+		return true;
+	}
+
+	// One read of what the bot wrote; false when it closed its output
+	bool receive()
+	{
+		char buffer[4096];
+		ssize_t n = read(fromBot, buffer, sizeof(buffer));
+		if (n <= 0)
+			return false;
+		pending.append(buffer, n);
+		return true;
+	}
+
+	void stop()
+	{
+		if (toBot >= 0)
+			close(toBot);
+		if (fromBot >= 0)
+			close(fromBot);
+		toBot = fromBot = -1;
+		if (pid > 0)
+		{
+			kill(pid, SIGKILL);
+			waitpid(pid, nullptr, 0);
+		}
+		pid = -1;
+	}
+};
+
+class MatchConfig
+{
+public:
+	string bots[2];
+	uint64_t seed;
+	int firstTurnTimeout;
+	int turnTimeout;
+	bool keepStderr;
+	bool verbose;
+
+	MatchConfig() : seed(1), firstTurnTimeout(FIRST_TURN_TIMEOUT), turnTimeout(TURN_TIMEOUT), keepStderr(false), verbose(false) {}
+};
+
+class MatchResult
+{
+public:
+	int scores[2];
+	bool timedOut[2];
+	int turns;
+
+	MatchResult() : scores{0, 0}, timedOut{false, false}, turns(0) {}
+
+	// 0 or 1 for the winner, -1 for a draw
+	int winner() const
+	{
+		if (timedOut[0] != timedOut[1])
+			return timedOut[0] ? 1 : 0;
+		if (scores[0] == scores[1])
+			return -1;
+		return scores[0] > scores[1] ? 0 : 1;
+	}
+};
+
+class Referee
+{
+public:
+	vector<RefCreature> creatures;
+	vector<RefDrone> drones;
+	int turn;
+	int scores[2];
+	uint64_t saved[2];
+	// Color and type combos completed by each player, one bit each
+	int colorsDone[2];
+	int typesDone[2];
+
+	Referee(uint64_t seed) : turn(0), scores{0, 0}, saved{0, 0}, colorsDone{0, 0}, typesDone{0, 0}
+	{
+		RefereeRandom random(seed);
+		int nextId = 4;
+		// Fish come in pairs mirrored across x = MAP_SIZE / 2: colors 0/1 and 2/3
+		for (int type = 0; type < FISH_TYPES; type++)
+		{
+			for (int color = 0; color < FISH_COLORS; color += 2)
+			{
+				int x = random.nextInt(1000, MAP_SIZE / 2 - 500);
+				int y = random.nextInt(HABITAT_TOP[type + 1] + 300, HABITAT_BOTTOM[type + 1] - 300);
+				double angle = random.nextAngle();
+				int vx = lround(cos(angle) * FISH_SWIM_SPEED);
+				int vy = lround(sin(angle) * FISH_SWIM_SPEED);
+				creatures.push_back(RefCreature(nextId++, color, type, x, y, vx, vy));
+				creatures.push_back(RefCreature(nextId++, color + 1, type, MAP_SIZE - 1 - x, y, -vx, vy));
+			}
+		}
+		int monsterPairs = random.nextInt(1, 3);
+		for (int i = 0; i < monsterPairs; i++)
+		{
+			int x = random.nextInt(500, MAP_SIZE / 2 - 500);
+			int y = random.nextInt(5000, MAP_SIZE - 500);
+			double angle = random.nextAngle();
+			int vx = lround(cos(angle) * MONSTER_SPEED);
+			int vy = lround(sin(angle) * MONSTER_SPEED);
+			creatures.push_back(RefCreature(nextId++, -1, -1, x, y, vx, vy));
+			creatures.push_back(RefCreature(nextId++, -1, -1, MAP_SIZE - 1 - x, y, -vx, vy));
+		}
+		// Drone ids alternate between players; player 1 mirrors player 0
+		int left = random.nextInt(1500, 3000);
+		int right = random.nextInt(6000, 8500);
+		drones.push_back(RefDrone(0, 0, left, DRONE_START_Y));
+		drones.push_back(RefDrone(1, 1, MAP_SIZE - 1 - left, DRONE_START_Y));
+		drones.push_back(RefDrone(2, 0, right, DRONE_START_Y));
+		drones.push_back(RefDrone(3, 1, MAP_SIZE - 1 - right, DRONE_START_Y));
+	}
+
+	string initInput(int player)
+	{
+		(void)player;
+		string s = to_string(creatures.size()) + "\n";
+		for (auto &c : creatures)
+			s += to_string(c.id) + " " + to_string(c.color) + " " + to_string(c.type) + "\n";
+		return s;
+	}
+
+	string turnInput(int player)
+	{
+		int opp = 1 - player;
+		string s = to_string(scores[player]) + "\n" + to_string(scores[opp]) + "\n";
+		for (int p : {player, opp})
+		{
+			s += to_string(__builtin_popcountll(saved[p])) + "\n";
+			for (size_t i = 0; i < creatures.size(); i++)
+			{
+				if (saved[p] >> i & 1)
+					s += to_string(creatures[i].id) + "\n";
+			}
+		}
+		for (int p : {player, opp})
+		{
+			s += to_string(DRONES_PER_PLAYER) + "\n";
+			for (auto &d : drones)
+			{
+				if (d.owner == p)
+					s += to_string(d.id) + " " + to_string(d.x) + " " + to_string(d.y) + " " + to_string(d.emergency ? 1 : 0) + " " + to_string(d.battery) + "\n";
+			}
+		}
+		string scanLines;
+		int scanCount = 0;
+		for (auto &d : drones)
+		{
+			for (size_t i = 0; i < creatures.size(); i++)
+			{
+				if (d.scans >> i & 1)
+				{
+					scanLines += to_string(d.id) + " " + to_string(creatures[i].id) + "\n";
+					scanCount++;
+				}
+			}
+		}
+		s += to_string(scanCount) + "\n" + scanLines;
+
+		string visibleLines;
+		int visibleCount = 0;
+		for (auto &c : creatures)
+		{
+			if (c.lost)
+				continue;
+			bool seen = false;
+			for (auto &d : drones)
+			{
+				if (d.owner != player)
+					continue;
+				long long range = d.lightRadius() + (c.isMonster() ? MONSTER_DETECTED_RANGE_BONUS : 0);
+				if (squaredDistance(c.x, c.y, d.x, d.y) <= range * range)
+					seen = true;
+			}
+			if (!seen)
+				continue;
+			visibleLines += to_string(c.id) + " " + to_string(c.x) + " " + to_string(c.y) + " " + to_string(c.vx) + " " + to_string(c.vy) + "\n";
+			visibleCount++;
+		}
+		s += to_string(visibleCount) + "\n" + visibleLines;
+
+		string radarLines;
+		int radarCount = 0;
+		for (auto &d : drones)
+		{
+			if (d.owner != player)
+				continue;
+			for (auto &c : creatures)
+			{
+				if (c.lost)
+					continue;
+				radarLines += to_string(d.id) + " " + to_string(c.id) + " " + (c.y < d.y ? "T" : "B") + (c.x < d.x ? "L" : "R") + "\n";
+				radarCount++;
+			}
+		}
+		s += to_string(radarCount) + "\n" + radarLines;
+		return s;
+	}
+
+	// MOVE <x> <y> <light> [message] | WAIT <light> [message]
+	bool applyCommand(RefDrone &d, const string &line)
+	{
+		char word[8] = {};
+		int x;
+		int y;
+		int light;
+		if (sscanf(line.c_str(), "%7s", word) != 1)
+			return false;
+		if (strcmp(word, "MOVE") == 0)
+		{
+			if (sscanf(line.c_str(), "%*s %d %d %d", &x, &y, &light) != 3)
+				return false;
+			d.moving = true;
+			d.targetX = x;
+			d.targetY = y;
+		}
+		else if (strcmp(word, "WAIT") == 0)
+		{
+			if (sscanf(line.c_str(), "%*s %d", &light) != 1)
+				return false;
+			d.moving = false;
+		}
+		else
+			return false;
+		d.lightOn = light == 1 && !d.emergency && d.battery >= LIGHT_BATTERY_COST;
+		if (d.lightOn)
+			d.battery -= LIGHT_BATTERY_COST;
+		else
+			d.battery = min(DRONE_MAX_BATTERY, d.battery + DRONE_BATTERY_REGEN);
+		return true;
+	}
+
+	void moveDrone(RefDrone &d)
+	{
+		if (d.emergency)
+			d.y -= DRONE_EMERGENCY_SPEED;
+		else if (!d.moving)
+			d.y += DRONE_SINK_SPEED;
+		else
+		{
+			double dx = d.targetX - d.x;
+			double dy = d.targetY - d.y;
+			double distance = sqrt(dx * dx + dy * dy);
+			if (distance <= DRONE_MOVE_SPEED)
+			{
+				d.x = d.targetX;
+				d.y = d.targetY;
+			}
+			else
+			{
+				d.x += lround(dx / distance * DRONE_MOVE_SPEED);
+				d.y += lround(dy / distance * DRONE_MOVE_SPEED);
+			}
+		}
+		d.x = min(max(d.x, 0), MAP_SIZE - 1);
+		d.y = min(max(d.y, 0), MAP_SIZE - 1);
+	}
+
+	// Closest approach of two linear motions over the turn
+	static bool sweepHits(int ax, int ay, int avx, int avy, int bx, int by, int bvx, int bvy, int radius)
+	{
+		double rx = ax - bx;
+		double ry = ay - by;
+		double ux = avx - bvx;
+		double uy = avy - bvy;
+		double uu = ux * ux + uy * uy;
+		double t = uu > 0 ? min(1.0, max(0.0, -(rx * ux + ry * uy) / uu)) : 0;
+		double dx = rx + ux * t;
+		double dy = ry + uy * t;
+		return dx * dx + dy * dy <= (double)radius * radius;
+	}
+
+	void moveEverything()
+	{
+		vector<pair<int, int>> start;
+		for (auto &d : drones)
+			start.push_back(make_pair(d.x, d.y));
+		for (auto &d : drones)
+			moveDrone(d);
+		for (size_t k = 0; k < drones.size(); k++)
+		{
+			RefDrone &d = drones[k];
+			if (d.emergency)
+				continue;
+			int sx = start[k].first;
+			int sy = start[k].second;
+			for (auto &c : creatures)
+			{
+				if (!c.isMonster())
+					continue;
+				if (sweepHits(sx, sy, d.x - sx, d.y - sy, c.x, c.y, c.vx, c.vy, DRONE_HIT_RANGE + MONSTER_ATTACK_RANGE))
+				{
+					d.emergency = true;
+					d.lightOn = false;
+					d.scans = 0;
+					break;
+				}
+			}
+		}
+		for (auto &c : creatures)
+		{
+			if (c.lost)
+				continue;
+			c.x += c.vx;
+			c.y += c.vy;
+			if (c.x < 0 || c.x >= MAP_SIZE)
+			{
+				// Only fleeing fish swim out; anything else is kept on the map
+				if (c.fleeing)
+				{
+					c.lost = true;
+					continue;
+				}
+				c.x = min(max(c.x, 0), MAP_SIZE - 1);
+			}
+			int habitat = c.type + 1;
+			c.y = min(max(c.y, HABITAT_TOP[habitat]), HABITAT_BOTTOM[habitat]);
+		}
+	}
+
+	void scan()
+	{
+		for (auto &d : drones)
+		{
+			if (d.emergency)
+				continue;
+			long long range = d.lightRadius();
+			for (size_t i = 0; i < creatures.size(); i++)
+			{
+				RefCreature &c = creatures[i];
+				if (c.lost || c.isMonster() || (saved[d.owner] >> i & 1))
+					continue;
+				if (squaredDistance(c.x, c.y, d.x, d.y) <= range * range)
+					d.scans |= 1ULL << i;
+			}
+		}
+	}
+
+	int fishValue(int i)
+	{
+		return creatures[i].type + 1;
+	}
+
+	// Applies both players' saves at once: a bonus goes to everybody who gets there first on the same turn
+	void save(uint64_t newSaves[2])
+	{
+		uint64_t before[2] = {saved[0], saved[1]};
+		int colorsBefore[2] = {colorsDone[0], colorsDone[1]};
+		int typesBefore[2] = {typesDone[0], typesDone[1]};
+		for (int p = 0; p < 2; p++)
+		{
+			uint64_t fresh = newSaves[p] & ~saved[p];
+			for (size_t i = 0; i < creatures.size(); i++)
+			{
+				if (!(fresh >> i & 1))
+					continue;
+				bool first = !(before[1 - p] >> i & 1);
+				scores[p] += fishValue(i) * (first ? 2 : 1);
+			}
+			saved[p] |= fresh;
+		}
+		for (int p = 0; p < 2; p++)
+		{
+			for (int color = 0; color < FISH_COLORS; color++)
+			{
+				if (colorsDone[p] >> color & 1)
+					continue;
+				if (hasAll(saved[p], color, -1))
+				{
+					colorsDone[p] |= 1 << color;
+					scores[p] += COLOR_COMBO_POINTS * ((colorsBefore[1 - p] >> color & 1) ? 1 : 2);
+				}
+			}
+			for (int type = 0; type < FISH_TYPES; type++)
+			{
+				if (typesDone[p] >> type & 1)
+					continue;
+				if (hasAll(saved[p], -1, type))
+				{
+					typesDone[p] |= 1 << type;
+					scores[p] += TYPE_COMBO_POINTS * ((typesBefore[1 - p] >> type & 1) ? 1 : 2);
+				}
+			}
+		}
+	}
+
+	// Whether the mask holds every fish of the color (or of the type), lost fish included
+	bool hasAll(uint64_t mask, int color, int type)
+	{
+		for (size_t i = 0; i < creatures.size(); i++)
+		{
+			RefCreature &c = creatures[i];
+			if (c.isMonster())
+				continue;
+			if ((color < 0 || c.color == color) && (type < 0 || c.type == type) && !(mask >> i & 1))
+				return false;
+		}
+		return true;
+	}
+
+	void surface()
+	{
+		uint64_t newSaves[2] = {0, 0};
+		for (auto &d : drones)
+		{
+			if (d.emergency && d.y <= SURFACE_Y)
+				d.emergency = false;
+			if (!d.emergency && d.y <= SURFACE_Y)
+			{
+				newSaves[d.owner] |= d.scans;
+				d.scans = 0;
+			}
+		}
+		save(newSaves);
+		for (auto &d : drones)
+			d.scans &= ~saved[d.owner];
+	}
+
+	static void setSpeed(RefCreature &c, double dx, double dy, int speed)
+	{
+		double norm = sqrt(dx * dx + dy * dy);
+		if (norm == 0)
+			return;
+		c.vx = lround(dx / norm * speed);
+		c.vy = lround(dy / norm * speed);
+	}
+
+	void updateSpeeds()
+	{
+		for (auto &c : creatures)
+		{
+			if (c.lost)
+				continue;
+			if (c.isMonster())
+				updateMonster(c);
+			else
+				updateFish(c);
+			// Bounce on the habitat limits and, unless fleeing, on the map sides
+			int habitat = c.type + 1;
+			if (c.y + c.vy < HABITAT_TOP[habitat] || c.y + c.vy > HABITAT_BOTTOM[habitat])
+				c.vy = -c.vy;
+			if (!c.fleeing && (c.x + c.vx < 0 || c.x + c.vx >= MAP_SIZE))
+				c.vx = -c.vx;
+		}
+	}
+
+	void updateFish(RefCreature &c)
+	{
+		double fleeX = 0;
+		double fleeY = 0;
+		int scary = 0;
+		for (auto &d : drones)
+		{
+			if (d.emergency)
+				continue;
+			if (squaredDistance(c.x, c.y, d.x, d.y) <= (long long)FISH_HEARING_RANGE * FISH_HEARING_RANGE)
+			{
+				fleeX += d.x;
+				fleeY += d.y;
+				scary++;
+			}
+		}
+		c.fleeing = scary > 0;
+		if (c.fleeing)
+		{
+			setSpeed(c, c.x - fleeX / scary, c.y - fleeY / scary, FISH_FLEE_SPEED);
+			return;
+		}
+		RefCreature *closest = nullptr;
+		long long best = (long long)FISH_AVOID_RANGE * FISH_AVOID_RANGE;
+		for (auto &o : creatures)
+		{
+			if (&o == &c || o.lost || o.isMonster())
+				continue;
+			long long dist = squaredDistance(c.x, c.y, o.x, o.y);
+			if (dist <= best)
+			{
+				best = dist;
+				closest = &o;
+			}
+		}
+		if (closest != nullptr)
+			setSpeed(c, c.x - closest->x, c.y - closest->y, FISH_SWIM_SPEED);
+		else
+			setSpeed(c, c.vx, c.vy, FISH_SWIM_SPEED);
+	}
+
+	void updateMonster(RefCreature &c)
+	{
+		RefDrone *target = nullptr;
+		long long best = 0;
+		for (auto &d : drones)
+		{
+			if (d.emergency)
+				continue;
+			long long dist = squaredDistance(c.x, c.y, d.x, d.y);
+			long long range = d.lightRadius();
+			if (dist <= range * range && (target == nullptr || dist < best))
+			{
+				target = &d;
+				best = dist;
+			}
+		}
+		if (target != nullptr)
+		{
+			setSpeed(c, target->x - c.x, target->y - c.y, MONSTER_ATTACK_SPEED);
+			return;
+		}
+		RefCreature *closest = nullptr;
+		long long avoid = (long long)MONSTER_AVOID_RANGE * MONSTER_AVOID_RANGE;
+		for (auto &o : creatures)
+		{
+			if (&o == &c || !o.isMonster())
+				continue;
+			long long dist = squaredDistance(c.x, c.y, o.x, o.y);
+			if (dist <= avoid)
+			{
+				avoid = dist;
+				closest = &o;
+			}
+		}
+		if (closest != nullptr)
+			setSpeed(c, c.x - closest->x, c.y - closest->y, MONSTER_SPEED);
+		else if (abs(c.vx) + abs(c.vy) > 0)
+			setSpeed(c, c.vx, c.vy, MONSTER_SPEED);
+	}
+
+	// Nothing left that could change the score
+	bool settled()
+	{
+		for (int p = 0; p < 2; p++)
+		{
+			for (size_t i = 0; i < creatures.size(); i++)
+			{
+				RefCreature &c = creatures[i];
+				if (!c.isMonster() && !c.lost && !(saved[p] >> i & 1))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	void endGame()
+	{
+		uint64_t newSaves[2] = {0, 0};
+		for (auto &d : drones)
+		{
+			newSaves[d.owner] |= d.scans;
+			d.scans = 0;
+		}
+		save(newSaves);
+	}
+
+	// Runs one full turn with the commands already applied to the drones
+	void step()
+	{
+		moveEverything();
+		scan();
+		surface();
+		updateSpeeds();
+		turn++;
+	}
+};
+
+// Reads needed[p] lines from each bot, both at once. Each bot has one
+// deadline for all of its lines, counted from when its turn input was sent.
+// failed[p] is set when bot p missed its deadline or closed its output.
+static void readTurn(BotProcess *bots, const int *needed, const chrono::steady_clock::time_point *deadlines, vector<string> *lines, bool *failed)
+{
+	while (true)
+	{
+		pollfd fds[2];
+		int players[2];
+		int count = 0;
+		int timeout = -1;
+		auto now = chrono::steady_clock::now();
+		for (int p = 0; p < 2; p++)
+		{
+			string line;
+			while ((int)lines[p].size() < needed[p] && bots[p].nextLine(line))
+				lines[p].push_back(line);
+			if (failed[p] || (int)lines[p].size() >= needed[p])
+				continue;
+			int remaining = chrono::duration_cast<chrono::milliseconds>(deadlines[p] - now).count();
+			if (remaining <= 0)
+			{
+				failed[p] = true;
+				continue;
+			}
+			fds[count] = {bots[p].output(), POLLIN, 0};
+			players[count++] = p;
+			timeout = timeout < 0 ? remaining : min(timeout, remaining);
+		}
+		if (count == 0)
+			return;
+		if (poll(fds, count, timeout) < 0)
+			return;
+		for (int i = 0; i < count; i++)
+		{
+			if (fds[i].revents && !bots[players[i]].receive())
+				failed[players[i]] = true;
+		}
+	}
+}
+
+static MatchResult runMatch(const MatchConfig &config)
+{
+	signal(SIGPIPE, SIG_IGN);
+	Referee referee(config.seed);
+	MatchResult result;
+	BotProcess bots[2];
+	for (int p = 0; p < 2; p++)
+	{
+		if (!bots[p].start(config.bots[p], config.keepStderr) || !bots[p].send(referee.initInput(p)))
+			result.timedOut[p] = true;
+	}
+	while (referee.turn < MAX_TURNS && !result.timedOut[0] && !result.timedOut[1])
+	{
+		int timeout = referee.turn == 0 ? config.firstTurnTimeout : config.turnTimeout;
+		chrono::steady_clock::time_point deadlines[2];
+		for (int p = 0; p < 2; p++)
+		{
+			if (!bots[p].send(referee.turnInput(p)))
+				result.timedOut[p] = true;
+			deadlines[p] = chrono::steady_clock::now() + chrono::milliseconds(timeout);
+		}
+		int needed[2] = {0, 0};
+		for (auto &d : referee.drones)
+			needed[d.owner]++;
+		vector<string> lines[2];
+		bool failed[2] = {result.timedOut[0], result.timedOut[1]};
+		readTurn(bots, needed, deadlines, lines, failed);
+		for (int p = 0; p < 2; p++)
+		{
+			size_t next = 0;
+			for (auto &d : referee.drones)
+			{
+				if (d.owner != p || result.timedOut[p])
+					continue;
+				if (next >= lines[p].size() || !referee.applyCommand(d, lines[p][next++]))
+				{
+					if (config.verbose)
+						cerr << "turn " << referee.turn << ": player " << p << " gave no valid command for drone " << d.id << endl;
+					result.timedOut[p] = true;
+				}
+			}
+		}
+		if (result.timedOut[0] || result.timedOut[1])
+			break;
+		referee.step();
+		if (config.verbose)
+			cerr << "turn " << referee.turn << ": " << referee.scores[0] << " - " << referee.scores[1] << endl;
+		if (referee.settled())
+			break;
+	}
+	referee.endGame();
+	for (int p = 0; p < 2; p++)
+	{
+		bots[p].stop();
+		result.scores[p] = referee.scores[p];
+	}
+	result.turns = referee.turn;
+	return result;
+}
+
+#endif
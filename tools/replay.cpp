@@ -0,0 +1,118 @@
+// Feeds a replay recorded with REPLAY_FILE=<path> back into Game, turn by
+// turn, and checks that every command matches the recording and that every
+// drone carries as many scans as its "drone scan" lines list.
+// Searches that stop on the clock only reproduce with the same timings.
+// The replay must be built with the STRATEGY of the recording bot.
+// g++ -O2 -std=c++17 [-DSTRATEGY=N] -o replay tools/replay.cpp
+// ./replay [--print] <replay file>
+
+#define NO_BOT_MAIN
+#include "../main.cpp"
+
+// Scans listed per drone id in one turn's input; the first turn starts with the creature list
+static map<int, int> droneScans(const string &text, bool first)
+{
+	InputReader in(text.data(), text.size());
+	if (first)
+	{
+		int creatures = in.readInt();
+		for (int i = 0; i < creatures * 3; i++)
+			in.readInt();
+	}
+	in.readInt();
+	in.readInt();
+	for (int player = 0; player < 2; player++)
+	{
+		int saved = in.readInt();
+		for (int i = 0; i < saved; i++)
+			in.readInt();
+	}
+	map<int, int> scans;
+	for (int player = 0; player < 2; player++)
+	{
+		int drones = in.readInt();
+		for (int i = 0; i < drones; i++)
+		{
+			scans[in.readInt()] = 0;
+			for (int k = 0; k < 4; k++)
+				in.readInt();
+		}
+	}
+	int lines = in.readInt();
+	for (int i = 0; i < lines; i++)
+	{
+		scans[in.readInt()]++;
+		in.readInt();
+	}
+	return scans;
+}
+
+int main(int argc, char **argv)
+{
+	bool print = false;
+	const char *path = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--print")
+			print = true;
+		else
+			path = argv[i];
+	}
+	if (path == nullptr)
+	{
+		cerr << "usage: " << argv[0] << " [--print] <replay file>" << endl;
+		return 2;
+	}
+
+	ReplayReader replay;
+	if (!replay.load(path))
+	{
+		cerr << "cannot read replay " << path << " (missing, or not replay format " << REPLAY_VERSION << ")" << endl;
+		return 1;
+	}
+	if (replay.strategy != STRATEGY)
+	{
+		cerr << path << " was recorded with strategy " << replay.strategy << ", this replay is built with " << STRATEGY << ": build it with -DSTRATEGY=" << replay.strategy << endl;
+		return 1;
+	}
+	if (replay.frames.empty())
+	{
+		cout << path << ": no turn recorded" << endl;
+		return 0;
+	}
+
+	string input = replay.input();
+	InputReader source(input.data(), input.size());
+	Game game(source);
+	string output;
+	game.actionManager.fd = -1;
+	game.actionManager.capture = &output;
+
+	int mismatches = 0;
+	int scanMismatches = 0;
+	for (auto &f : replay.frames)
+	{
+		output.clear();
+		game.play();
+		if (print)
+			cout << "turn " << f.turn << "\n" << output;
+		map<int, int> scans = droneScans(f.input, &f == &replay.frames.front());
+		for (auto *drones : {&game.myDrones, &game.oppDrones})
+		{
+			for (auto &d : *drones)
+			{
+				if (d.scanCount == scans[d.id])
+					continue;
+				if (scanMismatches++ == 0)
+					cout << "turn " << f.turn << ": drone " << d.id << " carries " << d.scanCount << " scans, the input lists " << scans[d.id] << endl;
+			}
+		}
+		if (output == f.output)
+			continue;
+		if (mismatches++ == 0)
+			cout << "turn " << f.turn << " differs\nrecorded:\n" << f.output << "replayed:\n" << output;
+	}
+	cout << path << ": " << replay.frames.size() << " turns, " << mismatches << " differ, " << scanMismatches << " drone scan counts differ" << endl;
+	return mismatches == 0 && scanMismatches == 0 ? 0 : 1;
+}
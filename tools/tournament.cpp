@@ -0,0 +1,163 @@
+// Plays seeded matches between two bot binaries, one match per two cores, and reports
+// the win rate of the first one. Each seed is played twice, sides swapped.
+// g++ -O2 -std=c++17 -pthread -o tournament tools/tournament.cpp
+// ./tournament [--seeds N] [--first-seed S] [--threads T] [--timeout MS] [--csv FILE] <botA> <botB>
+
+#include "referee.hpp"
+
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class Job
+{
+public:
+	uint64_t seed;
+	bool swapped;
+	MatchResult result;
+};
+
+// One deque per worker: the owner takes from the back, idle workers steal from the front
+class WorkStealingScheduler
+{
+	vector<deque<int>> queues;
+	vector<mutex> locks;
+
+	bool take(int worker, int &job)
+	{
+		lock_guard<mutex> guard(locks[worker]);
+		if (queues[worker].empty())
+			return false;
+		job = queues[worker].back();
+		queues[worker].pop_back();
+		return true;
+	}
+
+	bool steal(int worker, int &job)
+	{
+		int count = queues.size();
+		for (int k = 1; k < count; k++)
+		{
+			int victim = (worker + k) % count;
+			lock_guard<mutex> guard(locks[victim]);
+			if (queues[victim].empty())
+				continue;
+			job = queues[victim].front();
+			queues[victim].pop_front();
+			return true;
+		}
+		return false;
+	}
+
+public:
+	WorkStealingScheduler(int workers, int jobs) : queues(workers), locks(workers)
+	{
+		for (int j = 0; j < jobs; j++)
+			queues[j % workers].push_back(j);
+	}
+
+	void run(const function<void(int)> &work)
+	{
+		vector<thread> threads;
+		for (int w = 0; w < (int)queues.size(); w++)
+		{
+			threads.push_back(thread([this, w, &work]() {
+				int job;
+				while (take(w, job) || steal(w, job))
+					work(job);
+			}));
+		}
+		for (auto &t : threads)
+			t.join();
+	}
+};
+
+int main(int argc, char **argv)
+{
+	int seeds = 100;
+	uint64_t firstSeed = 1;
+	// A match runs two bot processes: one match per two cores keeps the time budgets honest
+	int threads = thread::hardware_concurrency() / 2;
+	string csvPath;
+	MatchConfig base;
+	vector<string> bots;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--seeds" && i + 1 < argc)
+			seeds = atoi(argv[++i]);
+		else if (arg == "--first-seed" && i + 1 < argc)
+			firstSeed = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--threads" && i + 1 < argc)
+			threads = atoi(argv[++i]);
+		else if (arg == "--timeout" && i + 1 < argc)
+			base.turnTimeout = atoi(argv[++i]);
+		else if (arg == "--csv" && i + 1 < argc)
+			csvPath = argv[++i];
+		else
+			bots.push_back(arg);
+	}
+	if (bots.size() != 2 || seeds <= 0)
+	{
+		cerr << "usage: " << argv[0] << " [--seeds N] [--first-seed S] [--threads T] [--timeout MS] [--csv FILE] <botA> <botB>" << endl;
+		return 2;
+	}
+	threads = max(1, threads);
+
+	vector<Job> jobs(seeds * 2);
+	for (int i = 0; i < seeds * 2; i++)
+	{
+		jobs[i].seed = firstSeed + i / 2;
+		jobs[i].swapped = i % 2 == 1;
+	}
+
+	auto start = chrono::steady_clock::now();
+	WorkStealingScheduler scheduler(threads, jobs.size());
+	scheduler.run([&](int j) {
+		MatchConfig config = base;
+		config.seed = jobs[j].seed;
+		config.bots[0] = bots[jobs[j].swapped ? 1 : 0];
+		config.bots[1] = bots[jobs[j].swapped ? 0 : 1];
+		jobs[j].result = runMatch(config);
+	});
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	// Outcomes from botA's point of view
+	int wins = 0;
+	int losses = 0;
+	int draws = 0;
+	int timeouts[2] = {0, 0};
+	ofstream csv;
+	if (!csvPath.empty())
+	{
+		csv.open(csvPath);
+		csv << "seed,a_side,a_score,b_score,outcome" << endl;
+	}
+	for (auto &job : jobs)
+	{
+		int a = job.swapped ? 1 : 0;
+		int winner = job.result.winner();
+		const char *outcome = winner < 0 ? "draw" : winner == a ? "win" : "loss";
+		wins += winner == a;
+		losses += winner == 1 - a;
+		draws += winner < 0;
+		timeouts[0] += job.result.timedOut[a];
+		timeouts[1] += job.result.timedOut[1 - a];
+		if (csv.is_open())
+			csv << job.seed << "," << a << "," << job.result.scores[a] << "," << job.result.scores[1 - a] << "," << outcome << endl;
+	}
+
+	// Draws count as half a win; Wilson score interval at 95%
+	double n = jobs.size();
+	double p = (wins + 0.5 * draws) / n;
+	double z = 1.96;
+	double center = (p + z * z / (2 * n)) / (1 + z * z / n);
+	double margin = z * sqrt(p * (1 - p) / n + z * z / (4 * n * n)) / (1 + z * z / n);
+
+	printf("%s vs %s: %d games in %.1fs on %d threads\n", bots[0].c_str(), bots[1].c_str(), (int)n, elapsed, threads);
+	printf("wins %d, losses %d, draws %d, timeouts %d/%d\n", wins, losses, draws, timeouts[0], timeouts[1]);
+	printf("win rate %.1f%% (95%% CI %.1f%% - %.1f%%)\n", 100 * p, 100 * (center - margin), 100 * (center + margin));
+	return 0;
+}